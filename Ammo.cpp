@@ -4,7 +4,6 @@
 #include "Ammo.h"
 #include "Components/SphereComponent.h"
 #include "Components/BoxComponent.h"
-#include "Components/WidgetComponent.h"
 #include "Components/SphereComponent.h"
 #include "ShooterCharacter.h"
 
@@ -16,7 +15,6 @@ AAmmo::AAmmo()
 	SetRootComponent(AmmoMesh);
 
 	GetCollisionBox()->SetupAttachment(GetRootComponent());
-	GetPickupWidget()->SetupAttachment(GetRootComponent());
 	GetAreaSphere()->SetupAttachment(GetRootComponent());
 
 	AmmoCollisionSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AmmoCollisionSphere"));
@@ -34,7 +32,8 @@ void AAmmo::BeginPlay()
 {
 	Super::BeginPlay();
 
-	AmmoCollisionSphere->OnComponentBeginOverlap.AddDynamic(this, &AAmmo::AmmoSphereOverlap);
+	// Unique so a pooled ammo pickup never ends up bound twice
+	AmmoCollisionSphere->OnComponentBeginOverlap.AddUniqueDynamic(this, &AAmmo::AmmoSphereOverlap);
 }
 
 void AAmmo::SetItemProperties(EItemState State)
@@ -117,3 +116,18 @@ void AAmmo::DisableCustomDepth()
 	AmmoMesh->SetRenderCustomDepth(false);
 }
 
+void AAmmo::OnAcquiredFromPool(const FTransform& SpawnTransform)
+{
+	Super::OnAcquiredFromPool(SpawnTransform);
+
+	AmmoType = GetClass()->GetDefaultObject<AAmmo>()->AmmoType;
+
+	const USphereComponent* DefaultSphere = CastChecked<USphereComponent>(AmmoCollisionSphere->GetArchetype());
+	AmmoCollisionSphere->SetCollisionEnabled(DefaultSphere->GetCollisionEnabled());
+}
+
+UStaticMesh* AAmmo::GetInstanceMesh() const
+{
+	UStaticMesh* InstanceMesh = Super::GetInstanceMesh();
+	return InstanceMesh ? InstanceMesh : AmmoMesh->GetStaticMesh();
+}
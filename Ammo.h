@@ -58,9 +58,16 @@ public:
 
 	FORCEINLINE UStaticMeshComponent* GetAmmoMesh() const { return AmmoMesh;  }
 	FORCEINLINE EAmmoType GetAmmoType() const { return AmmoType; }
+	FORCEINLINE void SetAmmoType(EAmmoType Type) { AmmoType = Type; }
 
 	virtual void EnableCustomDepth() override;
 
 	virtual void DisableCustomDepth() override;
+
+	/* Re-arms AmmoCollisionSphere, which turns itself off once it has been overlapped, and restores the class AmmoType*/
+	virtual void OnAcquiredFromPool(const FTransform& SpawnTransform) override;
+
+	/* AmmoMesh's mesh unless an InstanceMesh is set*/
+	virtual UStaticMesh* GetInstanceMesh() const override;
 	
 };
@@ -4,3 +4,8 @@
 #include "BulletHitInterface.h"
 
 // Add default functionality here for any IBulletHitInterface functions that are not pure virtual.
+
+void IBulletHitInterface::BulletHitMerged_Implementation(FHitResult HitResult, int32 HitCount, float Intensity, AController* InstigatorController)
+{
+	BulletHit_Implementation(HitResult);
+}
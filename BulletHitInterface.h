@@ -6,6 +6,8 @@
 #include "UObject/Interface.h"
 #include "BulletHitInterface.generated.h"
 
+class AController;
+
 // This class does not need to be modified.
 UINTERFACE(MinimalAPI)
 class UBulletHitInterface : public UInterface
@@ -25,4 +27,15 @@ public:
 
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable)
 	void BulletHit(FHitResult HitResult);
+
+	/**
+	 * Every bullet that hit this actor in one frame, reported once.
+	 * @param HitResult The first hit of the frame
+	 * @param Intensity 0 for a single hit up to 1 for a burst; for scaling sounds and effects
+	 * @param InstigatorController Controller of whoever fired, for damage this hit goes on to cause
+	 * Defaults to BulletHit with the first hit
+	 */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable)
+	void BulletHitMerged(FHitResult HitResult, int32 HitCount, float Intensity, AController* InstigatorController);
+	virtual void BulletHitMerged_Implementation(FHitResult HitResult, int32 HitCount, float Intensity, AController* InstigatorController);
 };
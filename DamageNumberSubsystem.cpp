@@ -0,0 +1,159 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DamageNumberSubsystem.h"
+#include "DamageNumberWidget.h"
+#include "Blueprint/UserWidget.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/GameViewportClient.h"
+#include "GameFramework/PlayerController.h"
+#include "SceneView.h"
+
+void UDamageNumberSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Entries.SetNum(FMath::Max(MaxHitNumbers, 1));
+	Head = 0;
+	Count = 0;
+}
+
+void UDamageNumberSubsystem::Deinitialize()
+{
+	while (Count > 0)
+	{
+		PopEntry();
+	}
+	WidgetPools.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UDamageNumberSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDamageNumberSubsystem, STATGROUP_Tickables);
+}
+
+void UDamageNumberSubsystem::ShowDamageNumber(TSubclassOf<UDamageNumberWidget> WidgetClass, int32 Damage, const FVector& Location, float Lifetime)
+{
+	if (WidgetClass == nullptr) return;
+
+	UDamageNumberWidget* Widget = AcquireWidget(WidgetClass);
+	if (Widget == nullptr) return;
+
+	Widget->SetDamage(Damage);
+	Widget->SetVisibility(ESlateVisibility::HitTestInvisible);
+	PushEntry(Widget, Location, Lifetime, true);
+}
+
+void UDamageNumberSubsystem::TrackHitNumber(UUserWidget* Widget, const FVector& Location, float Lifetime)
+{
+	if (Widget == nullptr) return;
+
+	PushEntry(Widget, Location, Lifetime, false);
+}
+
+void UDamageNumberSubsystem::PushEntry(UUserWidget* Widget, const FVector& Location, float Lifetime, bool bPooled)
+{
+	if (Count == Entries.Num())
+	{
+		// Ring is full; the oldest number makes room
+		PopEntry();
+	}
+
+	FDamageNumberEntry& Entry = Entries[(Head + Count) % Entries.Num()];
+	Entry.Widget = Widget;
+	Entry.Location = Location;
+	Entry.ExpireTime = GetWorld()->GetTimeSeconds() + Lifetime;
+	Entry.bPooled = bPooled;
+	++Count;
+}
+
+void UDamageNumberSubsystem::PopEntry()
+{
+	ReleaseEntry(Entries[Head]);
+	Head = (Head + 1) % Entries.Num();
+	--Count;
+}
+
+UDamageNumberWidget* UDamageNumberSubsystem::AcquireWidget(TSubclassOf<UDamageNumberWidget> WidgetClass)
+{
+	FDamageNumberWidgetPool& Pool = WidgetPools.FindOrAdd(WidgetClass);
+	if (Pool.FreeWidgets.Num() > 0)
+	{
+		return Pool.FreeWidgets.Pop(false);
+	}
+
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (PlayerController == nullptr) return nullptr;
+
+	// Widgets stay in the viewport for their whole life and are hidden between uses
+	UDamageNumberWidget* Widget = CreateWidget<UDamageNumberWidget>(PlayerController, WidgetClass);
+	if (Widget)
+	{
+		Widget->AddToViewport();
+	}
+	return Widget;
+}
+
+void UDamageNumberSubsystem::ReleaseEntry(FDamageNumberEntry& Entry)
+{
+	if (IsValid(Entry.Widget))
+	{
+		UDamageNumberWidget* DamageNumberWidget = Cast<UDamageNumberWidget>(Entry.Widget);
+		if (Entry.bPooled && DamageNumberWidget)
+		{
+			DamageNumberWidget->SetVisibility(ESlateVisibility::Collapsed);
+			WidgetPools.FindOrAdd(DamageNumberWidget->GetClass()).FreeWidgets.Add(DamageNumberWidget);
+		}
+		else
+		{
+			Entry.Widget->RemoveFromParent();
+		}
+	}
+	Entry.Widget = nullptr;
+}
+
+void UDamageNumberSubsystem::Tick(float DeltaTime)
+{
+	if (Count == 0) return;
+
+	const float Now{ GetWorld()->GetTimeSeconds() };
+
+	// Numbers are pushed in the order they were shown, so expired ones are at the front
+	while (Count > 0 && Entries[Head].ExpireTime <= Now)
+	{
+		PopEntry();
+	}
+	if (Count == 0) return;
+
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	ULocalPlayer* LocalPlayer = PlayerController ? PlayerController->GetLocalPlayer() : nullptr;
+	if (LocalPlayer == nullptr || LocalPlayer->ViewportClient == nullptr) return;
+
+	// One view projection for every number this frame
+	FSceneViewProjectionData ProjectionData;
+	if (!LocalPlayer->GetProjectionData(LocalPlayer->ViewportClient->Viewport, ProjectionData)) return;
+
+	const FMatrix ViewProjectionMatrix{ ProjectionData.ComputeViewProjectionMatrix() };
+	const FIntRect ViewRect{ ProjectionData.GetConstrainedViewRect() };
+
+	for (int32 i = 0; i < Count; i++)
+	{
+		FDamageNumberEntry& Entry = Entries[(Head + i) % Entries.Num()];
+		if (!IsValid(Entry.Widget)) continue;
+
+		if (Entry.ExpireTime <= Now)
+		{
+			// Shorter lived than an older number; hide it until it reaches the front
+			Entry.Widget->SetVisibility(ESlateVisibility::Collapsed);
+			continue;
+		}
+
+		FVector2D ScreenPosition;
+		if (FSceneView::ProjectWorldToScreen(Entry.Location, ViewRect, ViewProjectionMatrix, ScreenPosition))
+		{
+			Entry.Widget->SetPositionInViewport(ScreenPosition);
+		}
+	}
+}
@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DamageNumberSubsystem.generated.h"
+
+class UUserWidget;
+class UDamageNumberWidget;
+
+/* A hit number on screen*/
+USTRUCT()
+struct FDamageNumberEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UUserWidget* Widget = nullptr;
+
+	/* World location the number is drawn at*/
+	FVector Location = FVector::ZeroVector;
+
+	/* World time the number is removed*/
+	float ExpireTime = 0.f;
+
+	/* Pooled widgets are hidden and reused, others are removed from their parent*/
+	bool bPooled = false;
+};
+
+/* Free widgets of one widget class*/
+USTRUCT()
+struct FDamageNumberWidgetPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<UDamageNumberWidget*> FreeWidgets;
+};
+
+/**
+ * Owns every hit number in the world.
+ * Live numbers sit in a ring buffer in the order they were shown, are projected
+ * to the screen together once a frame and expire from the front of the ring.
+ */
+UCLASS(Config = Game)
+class SHOOTER_API UDamageNumberSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/* Shows Damage at Location using a pooled widget of WidgetClass*/
+	void ShowDamageNumber(TSubclassOf<UDamageNumberWidget> WidgetClass, int32 Damage, const FVector& Location, float Lifetime);
+
+	/* Positions and expires a widget created elsewhere; it is removed from its parent when it expires*/
+	void TrackHitNumber(UUserWidget* Widget, const FVector& Location, float Lifetime);
+
+private:
+
+	/* Adds an entry to the back of the ring, expiring the oldest if the ring is full*/
+	void PushEntry(UUserWidget* Widget, const FVector& Location, float Lifetime, bool bPooled);
+
+	/* Removes the entry at the front of the ring*/
+	void PopEntry();
+
+	UDamageNumberWidget* AcquireWidget(TSubclassOf<UDamageNumberWidget> WidgetClass);
+
+	void ReleaseEntry(FDamageNumberEntry& Entry);
+
+	/* Live hit numbers; Head is the oldest*/
+	UPROPERTY()
+	TArray<FDamageNumberEntry> Entries;
+
+	int32 Head;
+	int32 Count;
+
+	UPROPERTY()
+	TMap<UClass*, FDamageNumberWidgetPool> WidgetPools;
+
+	/* Most hit numbers on screen at once*/
+	UPROPERTY(Config)
+	int32 MaxHitNumbers = 128;
+};
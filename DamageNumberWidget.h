@@ -0,0 +1,23 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "DamageNumberWidget.generated.h"
+
+/**
+ * Base class for pooled hit number widgets.
+ * The Blueprint child updates its text in SetDamage.
+ */
+UCLASS()
+class SHOOTER_API UDamageNumberWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+
+	/* Called each time the widget is taken from the pool*/
+	UFUNCTION(BlueprintImplementableEvent)
+	void SetDamage(int32 Damage);
+};
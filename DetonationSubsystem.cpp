@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DetonationSubsystem.h"
+#include "Kismet/GameplayStatics.h"
+#include "GameFramework/DamageType.h"
+#include "Explosive.h"
+#include "Shooter.h"
+
+DECLARE_CYCLE_STAT(TEXT("Detonations"), STAT_Detonations, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Explosives detonated"), STAT_ExplosivesDetonated, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pending detonations"), STAT_PendingDetonations, STATGROUP_Shooter);
+
+void UDetonationSubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_PendingDetonations, PendingDetonations.Num());
+	PendingDetonations.Empty();
+	Overlaps.Empty();
+	DamagedActors.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UDetonationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDetonationSubsystem, STATGROUP_Tickables);
+}
+
+void UDetonationSubsystem::QueueDetonation(AExplosive* Explosive, AController* Instigator)
+{
+	if (!IsValid(Explosive) || Explosive->IsDetonationQueued()) return;
+
+	Explosive->SetDetonationQueued();
+	PendingDetonations.Add({ Explosive, Instigator });
+	INC_DWORD_STAT(STAT_PendingDetonations);
+}
+
+void UDetonationSubsystem::Tick(float DeltaTime)
+{
+	if (PendingDetonations.Num() == 0) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_Detonations);
+
+	// Only what was queued before this tick; anything these set off waits a frame
+	const int32 NumDetonations{ FMath::Min(PendingDetonations.Num(), FMath::Max(MaxDetonationsPerFrame, 1)) };
+	for (int32 i = 0; i < NumDetonations; i++)
+	{
+		const FPendingDetonation& Pending = PendingDetonations[i];
+		AExplosive* Explosive = Pending.Explosive.Get();
+		if (IsValid(Explosive))
+		{
+			Detonate(Explosive, Pending.Instigator.Get());
+		}
+	}
+	PendingDetonations.RemoveAt(0, NumDetonations, false);
+	DEC_DWORD_STAT_BY(STAT_PendingDetonations, NumDetonations);
+}
+
+void UDetonationSubsystem::Detonate(AExplosive* Explosive, AController* Instigator)
+{
+	INC_DWORD_STAT(STAT_ExplosivesDetonated);
+
+	UWorld* World = GetWorld();
+	const FVector Origin{ Explosive->GetActorLocation() };
+	const float Radius{ Explosive->GetExplosionRadius() };
+
+	FCollisionObjectQueryParams ObjectParams;
+	ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
+	ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+	ObjectParams.AddObjectTypesToQuery(ECC_PhysicsBody);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ExplosionOverlap), false, Explosive);
+
+	Overlaps.Reset();
+	DamagedActors.Reset();
+	World->OverlapMultiByObjectType(Overlaps, Origin, FQuat::Identity, ObjectParams, FCollisionShape::MakeSphere(Radius), QueryParams);
+
+	// An actor can come back once per overlapping component; damage it once
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		AActor* Actor = Overlap.GetActor();
+		if (!IsValid(Actor) || Actor->IsPendingKillPending()) continue;
+
+		bool bAlreadyDamaged;
+		DamagedActors.Add(Actor, &bAlreadyDamaged);
+		if (bAlreadyDamaged) continue;
+
+		// Anything in between that isn't the actor itself soaks the blast
+		const FVector Target{ Actor->GetActorLocation() };
+		FHitResult BlockingHit;
+		QueryParams.TraceTag = SCENE_QUERY_STAT_NAME_ONLY(ExplosionLineOfSight);
+		if (World->LineTraceSingleByChannel(BlockingHit, Origin, Target, ECC_Visibility, QueryParams) &&
+			BlockingHit.GetActor() != Actor)
+		{
+			continue;
+		}
+
+		const float Damage{ Explosive->GetExplosionDamage() * GetFalloff(Explosive, FVector::Dist(Origin, Target)) };
+		if (Damage > 0.f)
+		{
+			UGameplayStatics::ApplyDamage(Actor, Damage, Instigator, Explosive, UDamageType::StaticClass());
+		}
+	}
+
+	Explosive->Explode();
+}
+
+float UDetonationSubsystem::GetFalloff(const AExplosive* Explosive, float Distance)
+{
+	const float InnerRadius{ Explosive->GetExplosionInnerRadius() };
+	const float OuterRadius{ Explosive->GetExplosionRadius() };
+	if (Distance <= InnerRadius) return 1.f;
+
+	// Clamped, since a large actor can overlap with its centre outside the radius
+	const float Alpha{ FMath::Clamp((Distance - InnerRadius) / FMath::Max(OuterRadius - InnerRadius, KINDA_SMALL_NUMBER), 0.f, 1.f) };
+	return FMath::Lerp(1.f, Explosive->GetExplosionMinimumDamageScale(), Alpha);
+}
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "DetonationSubsystem.generated.h"
+
+class AExplosive;
+
+/* An explosive waiting for its turn to go off*/
+struct FPendingDetonation
+{
+	TWeakObjectPtr<AExplosive> Explosive;
+
+	/* Credited with the damage; whoever set off the first barrel in a chain*/
+	TWeakObjectPtr<AController> Instigator;
+};
+
+/**
+ * Sets off explosives a few per frame. Each detonation makes one overlap query for
+ * everything in its radius, checks line of sight to each actor found and applies
+ * falloff damage. Explosives damaged that way are queued rather than detonated in
+ * place, so a chain reaction spreads over frames instead of recursing in one.
+ */
+UCLASS(Config = Game)
+class SHOOTER_API UDetonationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/* Queues Explosive to go off on a later tick. Explosives already queued are ignored*/
+	void QueueDetonation(AExplosive* Explosive, AController* Instigator);
+
+	UFUNCTION(BlueprintCallable, Category = "Detonation")
+	FORCEINLINE int32 GetNumPendingDetonations() const { return PendingDetonations.Num(); }
+
+private:
+
+	void Detonate(AExplosive* Explosive, AController* Instigator);
+
+	/* Damage scale for an actor Distance away from an explosive*/
+	static float GetFalloff(const AExplosive* Explosive, float Distance);
+
+	/* First in, first out*/
+	TArray<FPendingDetonation> PendingDetonations;
+
+	/* Scratch for Detonate's overlap query and the actors it found*/
+	TArray<FOverlapResult> Overlaps;
+	TSet<AActor*> DamagedActors;
+
+	/* Explosives set off per frame; the rest wait for the next*/
+	UPROPERTY(Config)
+	int32 MaxDetonationsPerFrame = 4;
+};
@@ -0,0 +1,203 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EmitterPoolSubsystem.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "GameFramework/WorldSettings.h"
+#include "Shooter.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Emitter pool hits"), STAT_EmitterPoolHits, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Emitter pool misses"), STAT_EmitterPoolMisses, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Emitter pool steals"), STAT_EmitterPoolSteals, STATGROUP_Shooter);
+
+void FEmitterPool::AddActive(UParticleSystemComponent* Component)
+{
+	ActiveComponents.Add(Component);
+	++NumActive;
+}
+
+UParticleSystemComponent* FEmitterPool::PopOldestActive()
+{
+	while (ActiveHead < ActiveComponents.Num() && ActiveComponents[ActiveHead] == nullptr)
+	{
+		++ActiveHead;
+	}
+	if (ActiveHead >= ActiveComponents.Num()) return nullptr;
+
+	UParticleSystemComponent* Component = ActiveComponents[ActiveHead];
+	ActiveComponents[ActiveHead++] = nullptr;
+	--NumActive;
+
+	// Drop the consumed front in one go once it is most of the array, so each steal stays O(1) amortised
+	if (ActiveHead * 2 >= ActiveComponents.Num())
+	{
+		ActiveComponents.RemoveAt(0, ActiveHead, false);
+		ActiveHead = 0;
+	}
+	return Component;
+}
+
+bool FEmitterPool::RemoveActive(UParticleSystemComponent* Component)
+{
+	for (int32 i = ActiveHead; i < ActiveComponents.Num(); i++)
+	{
+		if (ActiveComponents[i] == Component)
+		{
+			ActiveComponents[i] = nullptr;
+			if (--NumActive == 0)
+			{
+				ActiveComponents.Reset();
+				ActiveHead = 0;
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+void UEmitterPoolSubsystem::Deinitialize()
+{
+	for (auto& PoolPair : Pools)
+	{
+		for (UParticleSystemComponent* Component : PoolPair.Value.FreeComponents)
+		{
+			if (IsValid(Component))
+			{
+				Component->DestroyComponent();
+			}
+		}
+		for (UParticleSystemComponent* Component : PoolPair.Value.ActiveComponents)
+		{
+			if (IsValid(Component))
+			{
+				Component->DestroyComponent();
+			}
+		}
+	}
+	Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+UParticleSystemComponent* UEmitterPoolSubsystem::SpawnPooledEmitter(const UObject* WorldContextObject, UParticleSystem* Template, const FTransform& SpawnTransform)
+{
+	if (Template == nullptr) return nullptr;
+
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	if (World && World->IsGameWorld())
+	{
+		if (UEmitterPoolSubsystem* EmitterPool = World->GetSubsystem<UEmitterPoolSubsystem>())
+		{
+			return EmitterPool->SpawnEmitter(Template, SpawnTransform);
+		}
+	}
+	return UGameplayStatics::SpawnEmitterAtLocation(WorldContextObject, Template, SpawnTransform);
+}
+
+UParticleSystemComponent* UEmitterPoolSubsystem::SpawnEmitter(UParticleSystem* Template, const FTransform& SpawnTransform)
+{
+	if (Template == nullptr) return nullptr;
+
+	FEmitterPool& Pool = FindOrAddPool(Template);
+
+	UParticleSystemComponent* Component = nullptr;
+	if (Pool.FreeComponents.Num() > 0)
+	{
+		Component = Pool.FreeComponents.Pop(false);
+		++PoolHits;
+		INC_DWORD_STAT(STAT_EmitterPoolHits);
+	}
+	else if (Pool.Num() < Pool.MaxSize)
+	{
+		Component = CreatePooledComponent(Template);
+		++PoolMisses;
+		INC_DWORD_STAT(STAT_EmitterPoolMisses);
+	}
+	else if (Pool.NumActive > 0)
+	{
+		// Pool is at its cap; steal the oldest playing component
+		Component = Pool.PopOldestActive();
+		Component->DeactivateImmediate();
+		++PoolSteals;
+		INC_DWORD_STAT(STAT_EmitterPoolSteals);
+	}
+
+	if (Component == nullptr) return nullptr;
+
+	Pool.AddActive(Component);
+	Component->SetWorldTransform(SpawnTransform);
+	Component->ActivateSystem(true);
+	return Component;
+}
+
+void UEmitterPoolSubsystem::PrewarmPool(UParticleSystem* Template, int32 Count)
+{
+	if (Template == nullptr) return;
+
+	FEmitterPool& Pool = FindOrAddPool(Template);
+	const int32 TargetCount{ FMath::Min(Count, Pool.MaxSize) };
+	while (Pool.Num() < TargetCount)
+	{
+		Pool.FreeComponents.Add(CreatePooledComponent(Template));
+	}
+}
+
+void UEmitterPoolSubsystem::SetPoolCap(UParticleSystem* Template, int32 MaxSize)
+{
+	if (Template == nullptr) return;
+
+	FEmitterPool& Pool = FindOrAddPool(Template);
+	Pool.MaxSize = FMath::Max(MaxSize, 1);
+
+	// Drop free components over the new cap
+	while (Pool.FreeComponents.Num() > 0 && Pool.Num() > Pool.MaxSize)
+	{
+		Pool.FreeComponents.Pop(false)->DestroyComponent();
+	}
+}
+
+FEmitterPool& UEmitterPoolSubsystem::FindOrAddPool(UParticleSystem* Template)
+{
+	FEmitterPool* Pool = Pools.Find(Template);
+	if (Pool)
+	{
+		return *Pool;
+	}
+
+	FEmitterPool& NewPool = Pools.Add(Template);
+	NewPool.MaxSize = FMath::Max(DefaultMaxPoolSize, 1);
+	const int32 PrewarmCount{ FMath::Min(DefaultPrewarmCount, NewPool.MaxSize) };
+	for (int32 i = 0; i < PrewarmCount; i++)
+	{
+		NewPool.FreeComponents.Add(CreatePooledComponent(Template));
+	}
+	return NewPool;
+}
+
+UParticleSystemComponent* UEmitterPoolSubsystem::CreatePooledComponent(UParticleSystem* Template)
+{
+	// Same outer UGameplayStatics uses for world space emitters
+	UParticleSystemComponent* Component = NewObject<UParticleSystemComponent>(GetWorld()->GetWorldSettings());
+	Component->bAutoActivate = false;
+	Component->bAutoDestroy = false;
+	Component->SetTemplate(Template);
+	Component->SetUsingAbsoluteLocation(true);
+	Component->SetUsingAbsoluteRotation(true);
+	Component->SetUsingAbsoluteScale(true);
+	Component->OnSystemFinished.AddDynamic(this, &UEmitterPoolSubsystem::OnEmitterFinished);
+	Component->RegisterComponentWithWorld(GetWorld());
+	return Component;
+}
+
+void UEmitterPoolSubsystem::OnEmitterFinished(UParticleSystemComponent* PSystem)
+{
+	if (PSystem == nullptr) return;
+
+	FEmitterPool* Pool = Pools.Find(PSystem->Template);
+	if (Pool && Pool->RemoveActive(PSystem))
+	{
+		Pool->FreeComponents.Add(PSystem);
+	}
+}
@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EmitterPoolSubsystem.generated.h"
+
+class UParticleSystem;
+class UParticleSystemComponent;
+
+/* Recycled particle components for one template*/
+USTRUCT()
+struct FEmitterPool
+{
+	GENERATED_BODY()
+
+	/* Components ready to be reused*/
+	UPROPERTY()
+	TArray<UParticleSystemComponent*> FreeComponents;
+
+	/* Components currently playing, oldest at ActiveHead. Finished ones leave a null behind*/
+	UPROPERTY()
+	TArray<UParticleSystemComponent*> ActiveComponents;
+
+	/* Index of the oldest slot in ActiveComponents that may still be playing*/
+	int32 ActiveHead = 0;
+
+	/* Non-null entries in ActiveComponents*/
+	int32 NumActive = 0;
+
+	/* Most components this pool will ever create*/
+	int32 MaxSize = 0;
+
+	void AddActive(UParticleSystemComponent* Component);
+
+	/* Takes the oldest playing component out of the queue without shifting it*/
+	UParticleSystemComponent* PopOldestActive();
+
+	/* Clears Component's slot; false if it wasn't playing from this pool*/
+	bool RemoveActive(UParticleSystemComponent* Component);
+
+	FORCEINLINE int32 Num() const { return FreeComponents.Num() + NumActive; }
+};
+
+/**
+ * Pre-warms and recycles particle system components so firing doesn't
+ * allocate and register a new component for every muzzle flash, beam and impact.
+ * When a pool is at its cap the oldest playing component is stolen.
+ */
+UCLASS(Config = Game)
+class SHOOTER_API UEmitterPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	/* Spawns through the world's pool, or through UGameplayStatics if there isn't one*/
+	static UParticleSystemComponent* SpawnPooledEmitter(const UObject* WorldContextObject, UParticleSystem* Template, const FTransform& SpawnTransform);
+
+	/* Activates a pooled component for Template at SpawnTransform*/
+	UParticleSystemComponent* SpawnEmitter(UParticleSystem* Template, const FTransform& SpawnTransform);
+
+	/* Makes sure at least Count components exist for Template (up to its cap)*/
+	UFUNCTION(BlueprintCallable, Category = "Emitter Pool")
+	void PrewarmPool(UParticleSystem* Template, int32 Count);
+
+	/* Overrides the component cap for Template*/
+	UFUNCTION(BlueprintCallable, Category = "Emitter Pool")
+	void SetPoolCap(UParticleSystem* Template, int32 MaxSize);
+
+	UFUNCTION(BlueprintCallable, Category = "Emitter Pool")
+	FORCEINLINE int32 GetPoolHits() const { return PoolHits; }
+
+	UFUNCTION(BlueprintCallable, Category = "Emitter Pool")
+	FORCEINLINE int32 GetPoolMisses() const { return PoolMisses; }
+
+	UFUNCTION(BlueprintCallable, Category = "Emitter Pool")
+	FORCEINLINE int32 GetPoolSteals() const { return PoolSteals; }
+
+private:
+
+	FEmitterPool& FindOrAddPool(UParticleSystem* Template);
+
+	UParticleSystemComponent* CreatePooledComponent(UParticleSystem* Template);
+
+	/* Returns finished components to their free list*/
+	UFUNCTION()
+	void OnEmitterFinished(UParticleSystemComponent* PSystem);
+
+	UPROPERTY()
+	TMap<UParticleSystem*, FEmitterPool> Pools;
+
+	/* Components created for a template the first time it is used*/
+	UPROPERTY(Config)
+	int32 DefaultPrewarmCount = 4;
+
+	/* Default cap on components per template*/
+	UPROPERTY(Config)
+	int32 DefaultMaxPoolSize = 32;
+
+	/* Spawns served from a free component*/
+	int32 PoolHits = 0;
+
+	/* Spawns that had to create a component*/
+	int32 PoolMisses = 0;
+
+	/* Spawns that stole the oldest playing component*/
+	int32 PoolSteals = 0;
+};
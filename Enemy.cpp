@@ -5,21 +5,46 @@
 #include "Kismet/GameplayStatics.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Sound/SoundCue.h"
+#include "EmitterPoolSubsystem.h"
+#include "DamageNumberSubsystem.h"
+#include "DamageNumberWidget.h"
+#include "HealthBarSubsystem.h"
 #include "Blueprint/UserWidget.h"
+#include "Engine/SkeletalMesh.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "PhysicsEngine/SkeletalBodySetup.h"
+#include "Animation/AnimInstance.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
 
 // Sets default values
 AEnemy::AEnemy() :
+	MergedHitVolumeScale(0.5f),
+	MergedHitEffectScale(0.75f),
 	Health(100.f),
 	MaxHealth(100.f),
 	HealthBarDisplayTime(4.f),
 	bCanHitReact(true),
 	HitReactTimeMin(0.5f),
 	HitReactTimeMax(3.0f),
+	AnimUpdateScreenSizes({ 0.24f, 0.12f }),
+	AnimMaxInterpolatedRate(4),
+	bFullRateAnimation(false),
+	Significance(EEnemySignificance::ESIG_High),
 	HitNumberDestroyTime(1.5f)
 {
- 	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+	// Nothing runs in the actor tick; movement and the mesh are paced by significance
+	PrimaryActorTick.bCanEverTick = false;
 
+	for (float& Multiplier : HitZoneMultiplierTable)
+	{
+		Multiplier = 1.f;
+	}
+
+	// Full rate up close, fewer evaluations with interpolation further out, and only montages off screen
+	GetMesh()->bEnableUpdateRateOptimizations = true;
+	GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+	GetMesh()->OnAnimUpdateRateParamsCreated.BindUObject(this, &AEnemy::OnAnimUpdateRateParamsCreated);
 }
 
 // Called when the game starts or when spawned
@@ -28,13 +53,105 @@ void AEnemy::BeginPlay()
 	Super::BeginPlay();
 
 	GetMesh()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block);
-	
+
+	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+	{
+		AnimInstance->OnMontageEnded.AddUniqueDynamic(this, &AEnemy::OnHitMontageEnded);
+	}
+
+	BuildHitZoneTable();
+
+	if (UEnemySignificanceSubsystem* EnemySignificance = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>())
+	{
+		EnemySignificance->RegisterEnemy(this);
+	}
+}
+
+void AEnemy::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	HideHealthBar();
+
+	if (UEnemySignificanceSubsystem* EnemySignificance = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>())
+	{
+		EnemySignificance->UnregisterEnemy(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AEnemy::BuildHitZoneTable()
+{
+	for (int32 i = 0; i < static_cast<int32>(EHitZone::EHZ_Max); i++)
+	{
+		const float* Multiplier = HitZoneDamageMultipliers.Find(static_cast<EHitZone>(i));
+		HitZoneMultiplierTable[i] = Multiplier ? *Multiplier : 1.f;
+	}
+
+	BodyHitZones.Reset();
+	if (GetMesh()->GetSkeletalMeshAsset() == nullptr) return;
+
+	const FReferenceSkeleton& RefSkeleton = GetMesh()->GetSkeletalMeshAsset()->GetRefSkeleton();
+	const int32 NumBones{ RefSkeleton.GetNum() };
+
+	TArray<EHitZone> BoneHitZones;
+	BoneHitZones.SetNum(NumBones);
+
+	// Parents always come before their children in the reference skeleton
+	for (int32 BoneIndex = 0; BoneIndex < NumBones; BoneIndex++)
+	{
+		const FName BoneName{ RefSkeleton.GetBoneName(BoneIndex) };
+		const int32 ParentIndex{ RefSkeleton.GetParentIndex(BoneIndex) };
+
+		if (BoneName == HeadBone)
+		{
+			BoneHitZones[BoneIndex] = EHitZone::EHZ_Head;
+		}
+		else if (const EHitZone* Zone = HitZoneBones.Find(BoneName))
+		{
+			BoneHitZones[BoneIndex] = *Zone;
+		}
+		else
+		{
+			BoneHitZones[BoneIndex] = ParentIndex != INDEX_NONE ? BoneHitZones[ParentIndex] : EHitZone::EHZ_Torso;
+		}
+	}
+
+	// Traces report the physics body, so fold the bone table down to one entry per body
+	const UPhysicsAsset* PhysicsAsset = GetMesh()->GetPhysicsAsset();
+	if (PhysicsAsset == nullptr) return;
+
+	BodyHitZones.SetNum(PhysicsAsset->SkeletalBodySetups.Num());
+	for (int32 BodyIndex = 0; BodyIndex < PhysicsAsset->SkeletalBodySetups.Num(); BodyIndex++)
+	{
+		const USkeletalBodySetup* BodySetup = PhysicsAsset->SkeletalBodySetups[BodyIndex];
+		const int32 BoneIndex{ BodySetup ? RefSkeleton.FindBoneIndex(BodySetup->BoneName) : INDEX_NONE };
+		BodyHitZones[BodyIndex] = BoneHitZones.IsValidIndex(BoneIndex) ? BoneHitZones[BoneIndex] : EHitZone::EHZ_Torso;
+	}
+}
+
+EHitZone AEnemy::GetHitZone(const FHitResult& HitResult) const
+{
+	// Item is only a body index when the trace hit the skeletal mesh
+	if (HitResult.GetComponent() != GetMesh() || !BodyHitZones.IsValidIndex(HitResult.Item)) return EHitZone::EHZ_Torso;
+	return BodyHitZones[HitResult.Item];
 }
 
 void AEnemy::ShowHealthBar_Implementation()
 {
-	GetWorldTimerManager().ClearTimer(HealthBarTimer);
-	GetWorldTimerManager().SetTimer(HealthBarTimer, this, &AEnemy::HideHealthBar, HealthBarDisplayTime);
+	UHealthBarSubsystem* HealthBars = GetWorld()->GetSubsystem<UHealthBarSubsystem>();
+	if (HealthBars)
+	{
+		HealthBars->ShowHealthBar(this, MaxHealth > 0.f ? Health / MaxHealth : 0.f, HealthBarDisplayTime);
+	}
+}
+
+void AEnemy::HideHealthBar()
+{
+	UHealthBarSubsystem* HealthBars = GetWorld()->GetSubsystem<UHealthBarSubsystem>();
+	if (HealthBars)
+	{
+		HealthBars->HideHealthBar(this);
+	}
 }
 
 void AEnemy::Die()
@@ -44,11 +161,13 @@ void AEnemy::Die()
 
 void AEnemy::PlayHitMontage(FName Section, float PlayRate)
 {
-	if (bCanHitReact)
+	if (bCanHitReact && SignificanceSettings.bPlayHitReacts)
 	{
 		UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
 			if (AnimInstance)
 			{
+				// Skipped frames would delay the reaction, so evaluate every frame until it ends
+				SetAnimationFullRate(true);
 				AnimInstance->Montage_Play(HitMontage, PlayRate);
 				AnimInstance->Montage_JumpToSection(Section, HitMontage);
 			}
@@ -65,42 +184,63 @@ void AEnemy::ResetHitReactTimer()
 	bCanHitReact = true;
 }
 
-void AEnemy::StoreHitNumber(UUserWidget* HitNumber, FVector Location)
+void AEnemy::SetAnimationFullRate(bool bFullRate)
 {
-	HitNumbers.Add(HitNumber, Location);
+	bFullRateAnimation = bFullRate;
+	UpdateAnimationRate();
+}
 
-	FTimerHandle HitNumberTimer;
-	FTimerDelegate HitNumberDelegate;
-	HitNumberDelegate.BindUFunction(this, FName("DestroyHitNumber"), HitNumber);
-	GetWorld()->GetTimerManager().SetTimer(HitNumberTimer, HitNumberDelegate, HitNumberDestroyTime, false);
+void AEnemy::UpdateAnimationRate()
+{
+	GetMesh()->bEnableUpdateRateOptimizations = !bFullRateAnimation;
+	GetMesh()->SetComponentTickInterval(bFullRateAnimation ? 0.f : SignificanceSettings.AnimTickInterval);
 }
 
-void AEnemy::DestroyHitNumber(UUserWidget* HitNumber)
+void AEnemy::SetSignificance(EEnemySignificance NewSignificance, const FEnemySignificanceSettings& Settings)
 {
-	HitNumbers.Remove(HitNumber);
-	HitNumber->RemoveFromParent();
+	Significance = NewSignificance;
+	SignificanceSettings = Settings;
+
+	// Anything that could be on screen moves every frame
+	const bool bHidden{ NewSignificance == EEnemySignificance::ESIG_Hidden };
+	GetCharacterMovement()->SetComponentTickInterval(bHidden ? Settings.TickInterval : 0.f);
+	UpdateAnimationRate();
 }
 
-void AEnemy::UpdateHitNumbers()
+void AEnemy::OnHitMontageEnded(UAnimMontage* Montage, bool bInterrupted)
 {
-	for (auto HitPair : HitNumbers)
+	// A new hit react interrupts the old one and keeps the full rate
+	if (Montage == HitMontage && !GetMesh()->GetAnimInstance()->Montage_IsPlaying(HitMontage))
 	{
-		UUserWidget* HitNumber{ HitPair.Key };
-		const FVector Location{ HitPair.Value };
-		FVector2D ScreenPosition;
-		UGameplayStatics::ProjectWorldToScreen(GetWorld()->GetFirstPlayerController(), Location, ScreenPosition);
-
-		HitNumber->SetPositionInViewport(ScreenPosition);
+		SetAnimationFullRate(false);
 	}
 }
 
-// Called every frame
-void AEnemy::Tick(float DeltaTime)
+void AEnemy::OnAnimUpdateRateParamsCreated(FAnimUpdateRateParameters* Params)
 {
-	Super::Tick(DeltaTime);
+	if (Params == nullptr) return;
 
-	UpdateHitNumbers();
+	Params->BaseVisibleDistanceFactorThesholds = AnimUpdateScreenSizes;
+	Params->bInterpolateSkippedFrames = true;
+	Params->MaxEvalRateForInterpolation = AnimMaxInterpolatedRate;
+}
 
+void AEnemy::StoreHitNumber(UUserWidget* HitNumber, FVector Location)
+{
+	UDamageNumberSubsystem* DamageNumbers = GetWorld()->GetSubsystem<UDamageNumberSubsystem>();
+	if (DamageNumbers)
+	{
+		DamageNumbers->TrackHitNumber(HitNumber, Location, HitNumberDestroyTime);
+	}
+}
+
+void AEnemy::ShowHitNumber_Implementation(int32 Damage, FVector HitLocation)
+{
+	UDamageNumberSubsystem* DamageNumbers = GetWorld()->GetSubsystem<UDamageNumberSubsystem>();
+	if (DamageNumbers)
+	{
+		DamageNumbers->ShowDamageNumber(HitNumberWidgetClass, Damage, HitLocation, HitNumberDestroyTime);
+	}
 }
 
 float AEnemy::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
@@ -113,6 +253,11 @@ float AEnemy::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AC
 	else
 	{
 		Health -= DamageAmount;
+
+		if (UHealthBarSubsystem* HealthBars = GetWorld()->GetSubsystem<UHealthBarSubsystem>())
+		{
+			HealthBars->SetHealthFraction(this, MaxHealth > 0.f ? Health / MaxHealth : 0.f);
+		}
 	}
 	return 0.0f;
 }
@@ -126,14 +271,29 @@ void AEnemy::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 
 void AEnemy::BulletHit_Implementation(FHitResult HitResult)
 {
-	if (ImpactSound)
+	BulletHitMerged_Implementation(HitResult, 1, 0.f, nullptr);
+}
+
+void AEnemy::BulletHitMerged_Implementation(FHitResult HitResult, int32 HitCount, float Intensity, AController* InstigatorController)
+{
+	if (UEnemySignificanceSubsystem* EnemySignificance = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>())
+	{
+		EnemySignificance->NotifyCombat(this);
+	}
+
+	if (ImpactSound && SignificanceSettings.bPlayImpactSounds)
 	{
-		UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, GetActorLocation());
+		UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, GetActorLocation(), 1.f + Intensity * MergedHitVolumeScale);
 	}
 
-	if (ImpactParticles)
+	if (ImpactParticles && SignificanceSettings.bSpawnImpactEffects)
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(this, ImpactParticles, HitResult.Location, FRotator(0.f), true);
+		const FVector Scale{ 1.f + Intensity * MergedHitEffectScale };
+		UParticleSystemComponent* Impact = UEmitterPoolSubsystem::SpawnPooledEmitter(this, ImpactParticles, FTransform(FRotator(0.f), HitResult.Location, Scale));
+		if (Impact)
+		{
+			Impact->SetFloatParameter(FName("Intensity"), Intensity);
+		}
 	}
 	ShowHealthBar();
 	PlayHitMontage(FName("HitReactFront"));
@@ -5,8 +5,12 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "BulletHitInterface.h"
+#include "HitZone.h"
+#include "EnemySignificanceSubsystem.h"
 #include "Enemy.generated.h"
 
+struct FAnimUpdateRateParameters;
+
 UCLASS()
 class SHOOTER_API AEnemy : public ACharacter, public IBulletHitInterface
 {
@@ -20,11 +24,13 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	UFUNCTION(BlueprintNativeEvent)
 	void ShowHealthBar();
 	void ShowHealthBar_Implementation();
 
-	UFUNCTION(BlueprintImplementableEvent)
+	UFUNCTION(BlueprintCallable)
 	void HideHealthBar();
 
 	void Die();
@@ -33,13 +39,25 @@ protected:
 
 	void ResetHitReactTimer();
 
-	UFUNCTION(BlueprintCallable)
-	void StoreHitNumber(UUserWidget* HitNumber, FVector Location);
+	/* Turns update rate optimisation off so a hit react shows on the very next frame, or back on*/
+	void SetAnimationFullRate(bool bFullRate);
 
+	/* Applies the full rate flag and the significance's mesh tick interval*/
+	void UpdateAnimationRate();
+
+	/* Drops back to the reduced rate once the hit react is over*/
 	UFUNCTION()
-	void DestroyHitNumber(UUserWidget* HitNumber);
+	void OnHitMontageEnded(UAnimMontage* Montage, bool bInterrupted);
+
+	/* Applies the distance steps and skipped frame interpolation when the mesh sets up its update rate*/
+	void OnAnimUpdateRateParamsCreated(FAnimUpdateRateParameters* Params);
 
-	void UpdateHitNumbers();
+	/* Resolves HitZoneBones against the skeleton into BodyHitZones*/
+	void BuildHitZoneTable();
+
+	/* Hands a hit number widget created in Blueprint to the damage number subsystem*/
+	UFUNCTION(BlueprintCallable)
+	void StoreHitNumber(UUserWidget* HitNumber, FVector Location);
 
 private:
 
@@ -51,6 +69,14 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, category = "Combat", meta = (AllowPrivateAccess = "true"))
 	class USoundCue* ImpactSound;
 
+	/* Extra impact volume at full merged hit intensity*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, category = "Combat", meta = (AllowPrivateAccess = "true"))
+	float MergedHitVolumeScale;
+
+	/* Extra impact effect scale at full merged hit intensity*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, category = "Combat", meta = (AllowPrivateAccess = "true"))
+	float MergedHitEffectScale;
+
 	/* Current Health of the enemy*/
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, category = "Combat", meta = (AllowPrivateAccess = "true"))
 	float Health;
@@ -58,16 +84,28 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, category = "Combat", meta = (AllowPrivateAccess = "true"))
 	float MaxHealth;
 
-	/* Name of the head bone*/
+	/* Name of the head bone. The bone and its children are the head zone*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, category = "Combat", meta = (AllowPrivateAccess = "true"))
+	FName HeadBone;
+
+	/* Bones that start a hit zone. Children inherit their parent's zone; unlisted roots are torso*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, category = "Combat", meta = (AllowPrivateAccess = "true"))
+	TMap<FName, EHitZone> HitZoneBones;
+
+	/* Damage multiplier for each hit zone on this enemy. Zones not listed use 1*/
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, category = "Combat", meta = (AllowPrivateAccess = "true"))
-	FString HeadBone;
+	TMap<EHitZone, float> HitZoneDamageMultipliers;
+
+	/* Hit zone of each physics body, indexed like the mesh's bodies (HitResult.Item on a skeletal hit)*/
+	TArray<EHitZone> BodyHitZones;
+
+	/* HitZoneDamageMultipliers indexed by EHitZone*/
+	float HitZoneMultiplierTable[static_cast<int32>(EHitZone::EHZ_Max)];
 
 	/* time to display health bar once shot*/
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, category = "Combat", meta = (AllowPrivateAccess = "true"));
 	float HealthBarDisplayTime;
 
-	FTimerHandle HealthBarTimer;
-
 	/* Montage containing hit and death animations*/
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, category = "Combat", meta = (AllowPrivateAccess = "true"));
 	UAnimMontage* HitMontage;
@@ -82,18 +120,33 @@ private:
 
 	bool bCanHitReact;
 
-	/* Map to store HitNumber widgets and their hit locations*/
-	UPROPERTY(VisibleAnywhere, Category = "Combat", meta = (AllowPrivateAccess = "true"));
-	TMap<UUserWidget*, FVector> HitNumbers;
+	/* Screen sizes below which the pose is evaluated every 2nd, 3rd, ... frame. Largest first*/
+	UPROPERTY(EditAnywhere, category = "Animation", meta = (AllowPrivateAccess = "true"))
+	TArray<float> AnimUpdateScreenSizes;
+
+	/* Most frames skipped while still interpolating between evaluations*/
+	UPROPERTY(EditAnywhere, category = "Animation", meta = (AllowPrivateAccess = "true"))
+	int32 AnimMaxInterpolatedRate;
+
+	/* True while a hit react needs every frame evaluated*/
+	bool bFullRateAnimation;
+
+	/* Set by the significance subsystem*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, category = "Significance", meta = (AllowPrivateAccess = "true"))
+	EEnemySignificance Significance;
+
+	/* What this enemy may do at its current significance*/
+	FEnemySignificanceSettings SignificanceSettings;
+
+	/* Widget class used for pooled hit numbers*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, category = "Combat", meta = (AllowPrivateAccess = "true"));
+	TSubclassOf<class UDamageNumberWidget> HitNumberWidgetClass;
 
 	/* Time Before a hit number is removed from the screen*/
 	UPROPERTY(EditAnywhere, category = "Combat", meta = (AllowPrivateAccess = "true"));
 	float HitNumberDestroyTime;
 
 public:	
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
 	virtual float TakeDamage(float DamageAmount, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) override;
 
 	// Called to bind functionality to input
@@ -101,9 +154,23 @@ public:
 
 	virtual void BulletHit_Implementation(FHitResult HitResult) override;
 
-	FORCEINLINE FString GetHeadBone() const { return HeadBone; }
+	/* One impact sound, effect and hit react for every bullet this frame, louder and bigger with Intensity*/
+	virtual void BulletHitMerged_Implementation(FHitResult HitResult, int32 HitCount, float Intensity, AController* InstigatorController) override;
+
+	FORCEINLINE FName GetHeadBone() const { return HeadBone; }
+
+	/* Hit zone of the physics body that was hit, indexed by HitResult.Item. Array lookup, no string work*/
+	EHitZone GetHitZone(const FHitResult& HitResult) const;
 
-	UFUNCTION(BlueprintImplementableEvent)
+	FORCEINLINE float GetHitZoneMultiplier(EHitZone Zone) const { return HitZoneMultiplierTable[static_cast<int32>(Zone)]; }
+
+	/* Scales tick and animation rate and gates hit effects*/
+	void SetSignificance(EEnemySignificance NewSignificance, const FEnemySignificanceSettings& Settings);
+
+	FORCEINLINE EEnemySignificance GetSignificance() const { return Significance; }
+
+	UFUNCTION(BlueprintNativeEvent)
 	void ShowHitNumber(int32 Damage, FVector HitLocation);
+	void ShowHitNumber_Implementation(int32 Damage, FVector HitLocation);
 
 };
@@ -0,0 +1,251 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EnemySignificanceSubsystem.h"
+#include "Enemy.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+#include "Shooter.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy significance"), STAT_EnemySignificance, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("High significance enemies"), STAT_HighSignificanceEnemies, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Medium significance enemies"), STAT_MediumSignificanceEnemies, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Low significance enemies"), STAT_LowSignificanceEnemies, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Hidden enemies"), STAT_HiddenEnemies, STATGROUP_Shooter);
+
+namespace
+{
+	/* Where a player is looking from, for scoring*/
+	struct FSignificanceView
+	{
+		FVector Location;
+		float ScreenScale;
+	};
+
+	void AddSignificanceStat(EEnemySignificance Significance, int32 Amount)
+	{
+		switch (Significance)
+		{
+		case EEnemySignificance::ESIG_High:
+			INC_DWORD_STAT_BY(STAT_HighSignificanceEnemies, Amount);
+			break;
+		case EEnemySignificance::ESIG_Medium:
+			INC_DWORD_STAT_BY(STAT_MediumSignificanceEnemies, Amount);
+			break;
+		case EEnemySignificance::ESIG_Low:
+			INC_DWORD_STAT_BY(STAT_LowSignificanceEnemies, Amount);
+			break;
+		case EEnemySignificance::ESIG_Hidden:
+			INC_DWORD_STAT_BY(STAT_HiddenEnemies, Amount);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+void UEnemySignificanceSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	for (int32& Num : NumPerSignificance)
+	{
+		Num = 0;
+	}
+
+	// Defaults for anything the config doesn't set
+	const int32 NumConfigured{ SignificanceSettings.Num() };
+	SignificanceSettings.SetNum(static_cast<int32>(EEnemySignificance::ESIG_MAX));
+	if (NumConfigured <= static_cast<int32>(EEnemySignificance::ESIG_Low))
+	{
+		FEnemySignificanceSettings& Low = SignificanceSettings[static_cast<int32>(EEnemySignificance::ESIG_Low)];
+		Low.AnimTickInterval = 1.f / 15.f;
+		Low.bPlayImpactSounds = false;
+	}
+	if (NumConfigured <= static_cast<int32>(EEnemySignificance::ESIG_Hidden))
+	{
+		FEnemySignificanceSettings& Hidden = SignificanceSettings[static_cast<int32>(EEnemySignificance::ESIG_Hidden)];
+		Hidden.TickInterval = 0.1f;
+		Hidden.AnimTickInterval = 0.5f;
+		Hidden.bSpawnImpactEffects = false;
+		Hidden.bPlayImpactSounds = false;
+		Hidden.bPlayHitReacts = false;
+	}
+}
+
+void UEnemySignificanceSubsystem::Deinitialize()
+{
+	for (const FEnemySignificanceEntry& Entry : Entries)
+	{
+		AddSignificanceStat(Entry.Significance, -1);
+	}
+	Entries.Empty();
+	EntryIndices.Empty();
+	Ranking.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UEnemySignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemySignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void UEnemySignificanceSubsystem::RegisterEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr || EntryIndices.Contains(Enemy)) return;
+
+	EntryIndices.Add(Enemy, Entries.Num());
+	FEnemySignificanceEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.Enemy = Enemy;
+
+	// Full fidelity until the first pass has looked at it
+	SetEntrySignificance(Entry, EEnemySignificance::ESIG_High);
+}
+
+void UEnemySignificanceSubsystem::UnregisterEnemy(AEnemy* Enemy)
+{
+	int32 Index;
+	if (!EntryIndices.RemoveAndCopyValue(Enemy, Index)) return;
+
+	--NumPerSignificance[static_cast<int32>(Entries[Index].Significance)];
+	AddSignificanceStat(Entries[Index].Significance, -1);
+
+	Entries.RemoveAtSwap(Index, 1, false);
+	if (Entries.IsValidIndex(Index))
+	{
+		EntryIndices[Entries[Index].Enemy] = Index;
+	}
+}
+
+void UEnemySignificanceSubsystem::NotifyCombat(AEnemy* Enemy)
+{
+	if (const int32* Index = EntryIndices.Find(Enemy))
+	{
+		Entries[*Index].LastCombatTime = GetWorld()->GetTimeSeconds();
+	}
+}
+
+const FEnemySignificanceSettings& UEnemySignificanceSubsystem::GetSettings(EEnemySignificance Significance) const
+{
+	return SignificanceSettings[FMath::Min(static_cast<int32>(Significance), SignificanceSettings.Num() - 1)];
+}
+
+int32 UEnemySignificanceSubsystem::GetNumEnemies(EEnemySignificance Significance) const
+{
+	return Significance < EEnemySignificance::ESIG_MAX ? NumPerSignificance[static_cast<int32>(Significance)] : 0;
+}
+
+void UEnemySignificanceSubsystem::Tick(float DeltaTime)
+{
+	if (Entries.Num() == 0) return;
+
+	TimeSinceUpdate += DeltaTime;
+	if (TimeSinceUpdate < UpdateInterval) return;
+	TimeSinceUpdate = 0.f;
+
+	SCOPE_CYCLE_COUNTER(STAT_EnemySignificance);
+
+	ScoreEnemies();
+	AssignSignificance();
+}
+
+void UEnemySignificanceSubsystem::ScoreEnemies()
+{
+	// One view per local player; an enemy scores by the view it matters most to
+	TArray<FSignificanceView, TInlineAllocator<4>> Views;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (PlayerController == nullptr || !PlayerController->IsLocalController() || PlayerController->PlayerCameraManager == nullptr) continue;
+
+		const APlayerCameraManager* CameraManager = PlayerController->PlayerCameraManager;
+		const float HalfFOV{ FMath::DegreesToRadians(FMath::Max(CameraManager->GetFOVAngle(), 1.f) * 0.5f) };
+		Views.Add({ CameraManager->GetCameraLocation(), 1.f / FMath::Tan(HalfFOV) });
+	}
+
+	const float Now{ GetWorld()->GetTimeSeconds() };
+	for (FEnemySignificanceEntry& Entry : Entries)
+	{
+		AEnemy* Enemy = Entry.Enemy;
+		if (!IsValid(Enemy))
+		{
+			Entry.Score = 0.f;
+			continue;
+		}
+
+		float Score{ 0.f };
+		if (Enemy->WasRecentlyRendered(RecentlyRenderedTime))
+		{
+			// Roughly the fraction of the screen the enemy's bounds cover
+			const FVector Origin{ Enemy->GetMesh()->Bounds.Origin };
+			const float Radius{ Enemy->GetMesh()->Bounds.SphereRadius };
+			for (const FSignificanceView& View : Views)
+			{
+				const float Distance{ FMath::Max(static_cast<float>(FVector::Dist(View.Location, Origin)), 1.f) };
+				Score = FMath::Max(Score, Radius * View.ScreenScale / Distance);
+			}
+		}
+
+		if (Entry.LastCombatTime >= 0.f && Now - Entry.LastCombatTime <= CombatMemoryTime)
+		{
+			Score += CombatScoreBonus;
+		}
+		Entry.Score = Score;
+	}
+}
+
+void UEnemySignificanceSubsystem::AssignSignificance()
+{
+	Ranking.Reset(Entries.Num());
+	for (int32 i = 0; i < Entries.Num(); i++)
+	{
+		Ranking.Add(i);
+	}
+	Ranking.Sort([this](int32 A, int32 B) { return Entries[A].Score > Entries[B].Score; });
+
+	int32 NumHigh{ 0 };
+	int32 NumMedium{ 0 };
+	for (const int32 Index : Ranking)
+	{
+		FEnemySignificanceEntry& Entry = Entries[Index];
+
+		EEnemySignificance Significance{ EEnemySignificance::ESIG_Hidden };
+		if (Entry.Score >= HighSignificanceScore && NumHigh < MaxHighSignificance)
+		{
+			Significance = EEnemySignificance::ESIG_High;
+			++NumHigh;
+		}
+		else if (Entry.Score >= MediumSignificanceScore && NumMedium < MaxMediumSignificance)
+		{
+			Significance = EEnemySignificance::ESIG_Medium;
+			++NumMedium;
+		}
+		else if (Entry.Score > 0.f)
+		{
+			Significance = EEnemySignificance::ESIG_Low;
+		}
+
+		SetEntrySignificance(Entry, Significance);
+	}
+}
+
+void UEnemySignificanceSubsystem::SetEntrySignificance(FEnemySignificanceEntry& Entry, EEnemySignificance Significance)
+{
+	if (Entry.Significance == Significance) return;
+
+	if (Entry.Significance != EEnemySignificance::ESIG_MAX)
+	{
+		--NumPerSignificance[static_cast<int32>(Entry.Significance)];
+		AddSignificanceStat(Entry.Significance, -1);
+	}
+	++NumPerSignificance[static_cast<int32>(Significance)];
+	AddSignificanceStat(Significance, 1);
+
+	Entry.Significance = Significance;
+	if (IsValid(Entry.Enemy))
+	{
+		Entry.Enemy->SetSignificance(Significance, GetSettings(Significance));
+	}
+}
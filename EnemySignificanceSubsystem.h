@@ -0,0 +1,147 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemySignificanceSubsystem.generated.h"
+
+class AEnemy;
+
+/* How much an enemy matters to the players right now, most significant first*/
+UENUM(BlueprintType)
+enum class EEnemySignificance : uint8
+{
+	ESIG_High		UMETA(DisplayName = "High"),
+	ESIG_Medium		UMETA(DisplayName = "Medium"),
+	ESIG_Low		UMETA(DisplayName = "Low"),
+	ESIG_Hidden		UMETA(DisplayName = "Hidden"),
+
+	ESIG_MAX		UMETA(DisplayName = "DefaultMax")
+};
+
+/* What an enemy is allowed to do at one significance*/
+USTRUCT()
+struct FEnemySignificanceSettings
+{
+	GENERATED_BODY()
+
+	/* Character movement tick interval, only used while Hidden so rendered enemies never step; 0 ticks every frame*/
+	UPROPERTY(Config)
+	float TickInterval = 0.f;
+
+	/* Mesh tick interval, which paces the animation update; 0 leaves it to update rate optimisation*/
+	UPROPERTY(Config)
+	float AnimTickInterval = 0.f;
+
+	UPROPERTY(Config)
+	bool bSpawnImpactEffects = true;
+
+	UPROPERTY(Config)
+	bool bPlayImpactSounds = true;
+
+	UPROPERTY(Config)
+	bool bPlayHitReacts = true;
+};
+
+/* An enemy being scored*/
+struct FEnemySignificanceEntry
+{
+	AEnemy* Enemy = nullptr;
+
+	float Score = 0.f;
+
+	/* World time the enemy was last hit*/
+	float LastCombatTime = -1.f;
+
+	EEnemySignificance Significance = EEnemySignificance::ESIG_MAX;
+};
+
+/**
+ * Scores every enemy by screen size, visibility and recent combat a few times a second,
+ * ranks them into significance buckets with a cap on the top buckets, and tells each enemy
+ * how often to tick and animate and whether its hits get effects, sounds and reactions.
+ */
+UCLASS(Config = Game)
+class SHOOTER_API UEnemySignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	void RegisterEnemy(AEnemy* Enemy);
+
+	void UnregisterEnemy(AEnemy* Enemy);
+
+	/* Enemy was just hit; it counts as in combat for CombatMemoryTime*/
+	void NotifyCombat(AEnemy* Enemy);
+
+	const FEnemySignificanceSettings& GetSettings(EEnemySignificance Significance) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Enemy Significance")
+	int32 GetNumEnemies(EEnemySignificance Significance) const;
+
+private:
+
+	/* Scores every enemy against the players' current views*/
+	void ScoreEnemies();
+
+	/* Ranks by score and hands each enemy its bucket*/
+	void AssignSignificance();
+
+	void SetEntrySignificance(FEnemySignificanceEntry& Entry, EEnemySignificance Significance);
+
+	TArray<FEnemySignificanceEntry> Entries;
+
+	TMap<AEnemy*, int32> EntryIndices;
+
+	/* Entry indices, best score first. Scratch for AssignSignificance*/
+	TArray<int32> Ranking;
+
+	int32 NumPerSignificance[static_cast<int32>(EEnemySignificance::ESIG_MAX)];
+
+	float TimeSinceUpdate = 0.f;
+
+	/* Settings for each significance, in bucket order*/
+	UPROPERTY(Config)
+	TArray<FEnemySignificanceSettings> SignificanceSettings;
+
+	/* Seconds between rescoring passes*/
+	UPROPERTY(Config)
+	float UpdateInterval = 0.1f;
+
+	/* Most enemies at High; the rest drop to Medium*/
+	UPROPERTY(Config)
+	int32 MaxHighSignificance = 16;
+
+	/* Most enemies at Medium; the rest drop to Low*/
+	UPROPERTY(Config)
+	int32 MaxMediumSignificance = 48;
+
+	/* Smallest score (about the fraction of the screen height the enemy fills) for High and Medium*/
+	UPROPERTY(Config)
+	float HighSignificanceScore = 0.15f;
+
+	UPROPERTY(Config)
+	float MediumSignificanceScore = 0.04f;
+
+	/* Seconds an enemy counts as in combat after being hit*/
+	UPROPERTY(Config)
+	float CombatMemoryTime = 3.f;
+
+	/* Added to the score of an enemy in combat*/
+	UPROPERTY(Config)
+	float CombatScoreBonus = 0.2f;
+
+	/* An enemy not rendered within this many seconds counts as off screen*/
+	UPROPERTY(Config)
+	float RecentlyRenderedTime = 0.2f;
+};
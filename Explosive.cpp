@@ -5,9 +5,16 @@
 #include "Kismet/GameplayStatics.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Sound/SoundCue.h"
+#include "EmitterPoolSubsystem.h"
+#include "DetonationSubsystem.h"
 
 // Sets default values
-AExplosive::AExplosive()
+AExplosive::AExplosive() :
+	ExplosionDamage(100.f),
+	ExplosionInnerRadius(150.f),
+	ExplosionRadius(500.f),
+	ExplosionMinimumDamageScale(0.1f),
+	bDetonationQueued(false)
 {
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
@@ -29,6 +36,35 @@ void AExplosive::Tick(float DeltaTime)
 }
 
 void AExplosive::BulletHit_Implementation(FHitResult HitResult)
+{
+	BulletHitMerged_Implementation(HitResult, 1, 0.f, nullptr);
+}
+
+void AExplosive::BulletHitMerged_Implementation(FHitResult HitResult, int32 HitCount, float Intensity, AController* InstigatorController)
+{
+	if (UDetonationSubsystem* Detonation = GetWorld()->GetSubsystem<UDetonationSubsystem>())
+	{
+		Detonation->QueueDetonation(this, InstigatorController);
+	}
+	else
+	{
+		Explode();
+	}
+}
+
+float AExplosive::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
+{
+	if (DamageAmount > 0.f && !bDetonationQueued)
+	{
+		if (UDetonationSubsystem* Detonation = GetWorld()->GetSubsystem<UDetonationSubsystem>())
+		{
+			Detonation->QueueDetonation(this, EventInstigator);
+		}
+	}
+	return Super::TakeDamage(DamageAmount, DamageEvent, EventInstigator, DamageCauser);
+}
+
+void AExplosive::Explode()
 {
 	if (ImpactSound)
 	{
@@ -37,10 +73,8 @@ void AExplosive::BulletHit_Implementation(FHitResult HitResult)
 
 	if (ExplodeParticles)
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(this, ExplodeParticles, HitResult.Location, FRotator(0.f), true);
+		UEmitterPoolSubsystem::SpawnPooledEmitter(this, ExplodeParticles, FTransform(FRotator(0.f), GetActorLocation()));
 	}
-	//TO DO: Apply explosive damage
 
 	Destroy();
 }
-
@@ -29,10 +29,44 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, category = "Combat", meta = (AllowPrivateAccess = "true"))
 	class USoundCue* ImpactSound;
 
+	/* Damage to anything within ExplosionInnerRadius*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, category = "Combat", meta = (AllowPrivateAccess = "true"))
+	float ExplosionDamage;
+
+	/* Full damage inside this radius, falling off toward ExplosionRadius*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, category = "Combat", meta = (AllowPrivateAccess = "true"))
+	float ExplosionInnerRadius;
+
+	/* Nothing outside this radius is damaged*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, category = "Combat", meta = (AllowPrivateAccess = "true"))
+	float ExplosionRadius;
+
+	/* Fraction of ExplosionDamage dealt at the edge of ExplosionRadius*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, category = "Combat", meta = (AllowPrivateAccess = "true", ClampMin = "0.0", ClampMax = "1.0"))
+	float ExplosionMinimumDamageScale;
+
+	/* True once waiting on the detonation subsystem, so a chain can't queue it twice*/
+	bool bDetonationQueued;
+
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
 	virtual void BulletHit_Implementation(FHitResult HitResult) override;
 
+	/* Queues the detonation, credited to whoever fired*/
+	virtual void BulletHitMerged_Implementation(FHitResult HitResult, int32 HitCount, float Intensity, AController* InstigatorController) override;
+
+	/* Damage from a neighbouring explosion queues this one too*/
+	virtual float TakeDamage(float DamageAmount, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) override;
+
+	/* Plays the explosion and removes the explosive. Damage has already been applied by the detonation subsystem*/
+	void Explode();
+
+	FORCEINLINE float GetExplosionDamage() const { return ExplosionDamage; }
+	FORCEINLINE float GetExplosionInnerRadius() const { return ExplosionInnerRadius; }
+	FORCEINLINE float GetExplosionRadius() const { return ExplosionRadius; }
+	FORCEINLINE float GetExplosionMinimumDamageScale() const { return ExplosionMinimumDamageScale; }
+	FORCEINLINE bool IsDetonationQueued() const { return bDetonationQueued; }
+	FORCEINLINE void SetDetonationQueued() { bDetonationQueued = true; }
 };
@@ -0,0 +1,10 @@
+#pragma once
+
+UENUM(BlueprintType)
+enum class EFireMode : uint8
+{
+	EFM_Hitscan 	UMETA(DisplayName = "Hitscan"),
+	EFM_Ballistic 	UMETA(DisplayName = "Ballistic"),
+
+	EFM_MAX 		UMETA(DisplayName = "DefaultMax")
+};
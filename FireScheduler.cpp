@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FireScheduler.h"
+
+void FFireScheduler::Start(float FireInterval, int32 InMaxShotsPerFrame)
+{
+	Interval = FMath::Max(FireInterval, KINDA_SMALL_NUMBER);
+	MaxShotsPerFrame = FMath::Max(InMaxShotsPerFrame, 1);
+	TimeUntilNextShot = Interval;
+	bActive = true;
+	StartFrame = GFrameCounter;
+}
+
+void FFireScheduler::Stop()
+{
+	bActive = false;
+	TimeUntilNextShot = 0.f;
+}
+
+int32 FFireScheduler::Advance(float DeltaTime, TArray<float>& OutShotAlphas)
+{
+	OutShotAlphas.Reset();
+	if (!bActive || DeltaTime <= 0.f || StartFrame == GFrameCounter) return 0;
+
+	TimeUntilNextShot -= DeltaTime;
+	while (TimeUntilNextShot <= 0.f && OutShotAlphas.Num() < MaxShotsPerFrame)
+	{
+		// TimeUntilNextShot is how long before the end of the frame the shot was due
+		OutShotAlphas.Add(FMath::Clamp((DeltaTime + TimeUntilNextShot) / DeltaTime, 0.f, 1.f));
+		TimeUntilNextShot += Interval;
+	}
+
+	if (TimeUntilNextShot <= 0.f)
+	{
+		// Hitch longer than MaxShotsPerFrame intervals; don't dump the backlog into later frames
+		TimeUntilNextShot = Interval;
+	}
+	return OutShotAlphas.Num();
+}
@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Frame-rate independent fire clock for automatic weapons.
+ * Time owed to the next shot carries over between frames, so several shots
+ * can fall inside one frame and the fire rate doesn't depend on the frame rate.
+ */
+struct SHOOTER_API FFireScheduler
+{
+public:
+
+	/* Starts the clock right after a shot; the next shot is due in FireInterval. This frame's Advance is skipped*/
+	void Start(float FireInterval, int32 InMaxShotsPerFrame);
+
+	void Stop();
+
+	FORCEINLINE bool IsActive() const { return bActive; }
+
+	/**
+	 * Advances the clock by DeltaTime.
+	 * @param OutShotAlphas For each shot due this frame, how far through the frame it falls (0 = last frame, 1 = now)
+	 * @return Number of shots due this frame
+	 */
+	int32 Advance(float DeltaTime, TArray<float>& OutShotAlphas);
+
+private:
+
+	/* Seconds between shots*/
+	float Interval = 0.1f;
+
+	/* Seconds until the next shot is due; negative when shots are owed*/
+	float TimeUntilNextShot = 0.f;
+
+	/* Shots owed past this are dropped instead of carried into the next frame*/
+	int32 MaxShotsPerFrame = 8;
+
+	bool bActive = false;
+
+	/* Frame Start was called on. Input runs before the pawn ticks, so that frame's DeltaTime is from before the shot*/
+	uint64 StartFrame = 0;
+};
@@ -2,4 +2,63 @@
 
 
 #include "GruxAnimInstance.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Kismet/KismetMathLibrary.h"
 
+UGruxAnimInstance::UGruxAnimInstance() :
+	Character(nullptr),
+	Speed(0.f),
+	bIsInAir(false),
+	bIsAccelerating(false),
+	MovementOffsetYaw(0.f)
+{
+
+}
+
+void UGruxAnimInstance::NativeInitializeAnimation()
+{
+	Super::NativeInitializeAnimation();
+
+	Character = Cast<ACharacter>(TryGetPawnOwner());
+}
+
+void UGruxAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
+{
+	Super::NativeUpdateAnimation(DeltaSeconds);
+
+	if (Character == nullptr)
+	{
+		Character = Cast<ACharacter>(TryGetPawnOwner());
+	}
+
+	Snapshot.bValid = Character != nullptr;
+	if (!Snapshot.bValid) return;
+
+	// Movement component reads must stay on the game thread
+	const UCharacterMovementComponent* Movement = Character->GetCharacterMovement();
+	Snapshot.Velocity = Character->GetVelocity();
+	Snapshot.bAccelerating = Movement->GetCurrentAcceleration().SizeSquared() > 0.f;
+	Snapshot.bFalling = Movement->IsFalling();
+	Snapshot.ActorRotation = Character->GetActorRotation();
+}
+
+void UGruxAnimInstance::NativeThreadSafeUpdateAnimation(float DeltaSeconds)
+{
+	Super::NativeThreadSafeUpdateAnimation(DeltaSeconds);
+
+	if (!Snapshot.bValid) return;
+
+	FVector Velocity{ Snapshot.Velocity };
+	Velocity.Z = 0;
+	Speed = Velocity.Size();
+
+	bIsInAir = Snapshot.bFalling;
+	bIsAccelerating = Snapshot.bAccelerating;
+
+	if (Speed > 0.f)
+	{
+		const FRotator MovementRotation{ UKismetMathLibrary::MakeRotFromX(Velocity) };
+		MovementOffsetYaw = UKismetMathLibrary::NormalizedDeltaRotator(MovementRotation, Snapshot.ActorRotation).Yaw;
+	}
+}
@@ -6,12 +6,57 @@
 #include "Animation/AnimInstance.h"
 #include "GruxAnimInstance.generated.h"
 
+/* Grux locomotion inputs: just velocity, acceleration, falling and facing, since the Grux has no aim offset or weapon state*/
+struct FGruxAnimSnapshot
+{
+	bool bValid = false;
+
+	FVector Velocity = FVector::ZeroVector;
+	bool bAccelerating = false;
+	bool bFalling = false;
+	FRotator ActorRotation = FRotator::ZeroRotator;
+};
+
 /**
- * 
+ * Drives the Grux locomotion blendspace natively, replacing the AnimBP event graph.
+ * Speed, air state and strafe yaw are derived from FGruxAnimSnapshot off the game thread.
  */
 UCLASS()
 class SHOOTER_API UGruxAnimInstance : public UAnimInstance
 {
 	GENERATED_BODY()
-	
+
+public:
+
+	UGruxAnimInstance();
+
+	virtual void NativeInitializeAnimation() override;
+
+	/* Reads the owning Grux's movement component into Snapshot*/
+	virtual void NativeUpdateAnimation(float DeltaSeconds) override;
+
+	/* Turns Snapshot into the blendspace inputs (Speed, bIsInAir, MovementOffsetYaw)*/
+	virtual void NativeThreadSafeUpdateAnimation(float DeltaSeconds) override;
+
+private:
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
+	class ACharacter* Character;
+
+	/** Lateral speed of the Grux*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
+	float Speed;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
+	bool bIsInAir;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
+	bool bIsAccelerating;
+
+	/** Yaw of the movement direction relative to where the Grux faces*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
+	float MovementOffsetYaw;
+
+	/* Latest movement state of the owning Grux; invalid until it has a pawn*/
+	FGruxAnimSnapshot Snapshot;
 };
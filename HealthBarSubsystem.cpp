@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HealthBarSubsystem.h"
+#include "Enemy.h"
+
+void UHealthBarSubsystem::Deinitialize()
+{
+	HealthBars.Empty();
+	BarIndices.Empty();
+
+	Super::Deinitialize();
+}
+
+void UHealthBarSubsystem::ShowHealthBar(AEnemy* Enemy, float HealthFraction, float Duration)
+{
+	if (Enemy == nullptr) return;
+
+	int32& Index = BarIndices.FindOrAdd(Enemy, INDEX_NONE);
+	if (Index == INDEX_NONE)
+	{
+		Index = HealthBars.AddDefaulted();
+		HealthBars[Index].Enemy = Enemy;
+	}
+
+	FHealthBarEntry& Entry = HealthBars[Index];
+	Entry.HealthFraction = FMath::Clamp(HealthFraction, 0.f, 1.f);
+	Entry.ExpireTime = GetWorld()->GetTimeSeconds() + Duration;
+}
+
+void UHealthBarSubsystem::SetHealthFraction(AEnemy* Enemy, float HealthFraction)
+{
+	if (const int32* Index = BarIndices.Find(Enemy))
+	{
+		HealthBars[*Index].HealthFraction = FMath::Clamp(HealthFraction, 0.f, 1.f);
+	}
+}
+
+void UHealthBarSubsystem::HideHealthBar(AEnemy* Enemy)
+{
+	if (const int32* Index = BarIndices.Find(Enemy))
+	{
+		RemoveAt(*Index);
+	}
+}
+
+void UHealthBarSubsystem::RemoveExpired(float Now)
+{
+	for (int32 i = HealthBars.Num() - 1; i >= 0; i--)
+	{
+		if (HealthBars[i].ExpireTime <= Now || !IsValid(HealthBars[i].Enemy))
+		{
+			RemoveAt(i);
+		}
+	}
+}
+
+void UHealthBarSubsystem::RemoveAt(int32 Index)
+{
+	BarIndices.Remove(HealthBars[Index].Enemy);
+
+	HealthBars.RemoveAtSwap(Index, 1, false);
+	if (HealthBars.IsValidIndex(Index))
+	{
+		BarIndices[HealthBars[Index].Enemy] = Index;
+	}
+}
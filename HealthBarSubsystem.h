@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HealthBarSubsystem.generated.h"
+
+class AEnemy;
+
+/* An enemy health bar on screen*/
+USTRUCT()
+struct FHealthBarEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	AEnemy* Enemy = nullptr;
+
+	/* Health over max health, 0 to 1*/
+	float HealthFraction = 0.f;
+
+	/* World time the bar is removed*/
+	float ExpireTime = 0.f;
+};
+
+/**
+ * Every enemy health bar being shown. Bars expire by timestamp and are drawn
+ * together by AShooterHUD, so there is no widget or timer per enemy.
+ */
+UCLASS()
+class SHOOTER_API UHealthBarSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	/* Shows Enemy's bar for Duration seconds, or refreshes it if it is already shown*/
+	void ShowHealthBar(AEnemy* Enemy, float HealthFraction, float Duration);
+
+	/* Updates the fill of a bar being shown; does nothing if Enemy has none*/
+	void SetHealthFraction(AEnemy* Enemy, float HealthFraction);
+
+	void HideHealthBar(AEnemy* Enemy);
+
+	/* Drops bars whose time is up and bars of destroyed enemies*/
+	void RemoveExpired(float Now);
+
+	FORCEINLINE const TArray<FHealthBarEntry>& GetHealthBars() const { return HealthBars; }
+
+private:
+
+	void RemoveAt(int32 Index);
+
+	UPROPERTY()
+	TArray<FHealthBarEntry> HealthBars;
+
+	/* Index of each enemy's bar in HealthBars*/
+	TMap<AEnemy*, int32> BarIndices;
+};
@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HitAggregationSubsystem.h"
+#include "Kismet/GameplayStatics.h"
+#include "GameFramework/DamageType.h"
+#include "ShooterCharacter.h"
+#include "BulletHitInterface.h"
+#include "Enemy.h"
+#include "Shooter.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bullet hits merged"), STAT_BulletHitsMerged, STATGROUP_Shooter);
+
+void UHitAggregationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// After actors and tickable subsystems, so the hitscan batch is already in
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UHitAggregationSubsystem::OnWorldPostActorTick);
+}
+
+void UHitAggregationSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	PendingHits.Empty();
+	FlushingHits.Empty();
+
+	Super::Deinitialize();
+}
+
+void UHitAggregationSubsystem::QueueHit(AShooterCharacter* Shooter, const FHitResult& HitResult, float Damage)
+{
+	AActor* Target = HitResult.GetActor();
+	if (Target == nullptr) return;
+
+	// A handful of targets per frame at most; a linear search beats a map here
+	FAggregatedHit* Hit = PendingHits.FindByPredicate([Target, Shooter](const FAggregatedHit& Pending)
+		{
+			return Pending.Target.Get() == Target && Pending.Shooter.Get() == Shooter;
+		});
+
+	if (Hit == nullptr)
+	{
+		Hit = &PendingHits.AddDefaulted_GetRef();
+		Hit->Target = Target;
+		Hit->Shooter = Shooter;
+		Hit->FirstHit = HitResult;
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_BulletHitsMerged);
+	}
+
+	Hit->LocationSum += HitResult.Location;
+	Hit->Damage += Damage;
+	++Hit->HitCount;
+}
+
+void UHitAggregationSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld())
+	{
+		FlushHits();
+	}
+}
+
+void UHitAggregationSubsystem::FlushHits()
+{
+	if (PendingHits.Num() == 0) return;
+
+	Swap(PendingHits, FlushingHits);
+
+	for (const FAggregatedHit& Hit : FlushingHits)
+	{
+		AActor* Target = Hit.Target.Get();
+		if (!IsValid(Target)) continue;
+
+		AShooterCharacter* Shooter = Hit.Shooter.Get();
+		AController* InstigatorController{ Shooter ? Shooter->GetController() : nullptr };
+		const float Intensity{ FullIntensityHitCount > 1
+			? FMath::Clamp(static_cast<float>(Hit.HitCount - 1) / (FullIntensityHitCount - 1), 0.f, 1.f)
+			: 1.f };
+
+		// Same order as a single hit: reaction first, then damage and the number
+		IBulletHitInterface* BulletHitInterface = Cast<IBulletHitInterface>(Target);
+		if (BulletHitInterface)
+		{
+			BulletHitInterface->BulletHitMerged_Implementation(Hit.FirstHit, Hit.HitCount, Intensity, InstigatorController);
+		}
+
+		AEnemy* HitEnemy = Cast<AEnemy>(Target);
+		if (IsValid(HitEnemy))
+		{
+			UGameplayStatics::ApplyDamage(HitEnemy,
+				Hit.Damage,
+				InstigatorController,
+				Shooter,
+				UDamageType::StaticClass());
+			HitEnemy->ShowHitNumber(static_cast<int32>(Hit.Damage), Hit.LocationSum / Hit.HitCount);
+		}
+	}
+	FlushingHits.Reset();
+}
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HitAggregationSubsystem.generated.h"
+
+class AShooterCharacter;
+
+/* Every bullet one shooter put into one target this frame*/
+struct FAggregatedHit
+{
+	TWeakObjectPtr<AActor> Target;
+
+	TWeakObjectPtr<AShooterCharacter> Shooter;
+
+	/* First hit of the frame; its bone and normal are used for the merged impact*/
+	FHitResult FirstHit;
+
+	/* Sum of hit locations, for the merged damage number*/
+	FVector LocationSum = FVector::ZeroVector;
+
+	float Damage = 0.f;
+
+	int32 HitCount = 0;
+};
+
+/**
+ * Collects bullet impacts during a frame and applies them once per target after
+ * every actor and the hitscan batch have ticked: one BulletHitMerged call with an
+ * intensity, one ApplyDamage with the summed damage and one merged damage number.
+ */
+UCLASS(Config = Game)
+class SHOOTER_API UHitAggregationSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	/* Adds a hit on HitResult's actor to this frame's total. Damage is only applied to enemies*/
+	void QueueHit(AShooterCharacter* Shooter, const FHitResult& HitResult, float Damage);
+
+	/* Applies every queued hit now*/
+	void FlushHits();
+
+private:
+
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	TArray<FAggregatedHit> PendingHits;
+
+	/* Scratch so hits queued while flushing wait for the next flush*/
+	TArray<FAggregatedHit> FlushingHits;
+
+	FDelegateHandle PostActorTickHandle;
+
+	/* Hits in one frame that count as full intensity*/
+	UPROPERTY(Config)
+	int32 FullIntensityHitCount = 5;
+};
@@ -0,0 +1,135 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HitscanSubsystem.h"
+#include "ShooterCharacter.h"
+#include "Weapon.h"
+
+void UHitscanSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	NextShotId = 0;
+	TraceDelegate.BindUObject(this, &UHitscanSubsystem::OnTraceCompleted);
+}
+
+void UHitscanSubsystem::Deinitialize()
+{
+	TraceDelegate.Unbind();
+	PendingShots.Empty();
+	CompletedShots.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UHitscanSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHitscanSubsystem, STATGROUP_Tickables);
+}
+
+void UHitscanSubsystem::QueueShot(AShooterCharacter* Shooter, AWeapon* Weapon, const FTransform& SocketTransform, const FVector& CrosshairStart, const FVector& CrosshairEnd)
+{
+	if (Weapon == nullptr) return;
+
+	const uint32 ShotId{ NextShotId++ };
+
+	FHitscanShot& Shot = PendingShots.Add(ShotId);
+	Shot.Shooter = Shooter;
+	Shot.BulletDamage = Weapon->GetBulletDamage();
+	Shot.SocketTransform = SocketTransform;
+	Shot.BeamEndLocation = CrosshairEnd;
+	Shot.Stage = EHitscanStage::EHS_Crosshair;
+
+	GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single,
+		CrosshairStart,
+		CrosshairEnd,
+		ECollisionChannel::ECC_Visibility,
+		FCollisionQueryParams::DefaultQueryParam,
+		FCollisionResponseParams::DefaultResponseParam,
+		&TraceDelegate,
+		ShotId);
+}
+
+void UHitscanSubsystem::QueueShotToTarget(AShooterCharacter* Shooter, AWeapon* Weapon, const FTransform& SocketTransform, const FVector& BeamEndLocation)
+{
+	if (Weapon == nullptr) return;
+
+	const uint32 ShotId{ NextShotId++ };
+
+	FHitscanShot& Shot = PendingShots.Add(ShotId);
+	Shot.Shooter = Shooter;
+	Shot.BulletDamage = Weapon->GetBulletDamage();
+	Shot.SocketTransform = SocketTransform;
+	Shot.BeamEndLocation = BeamEndLocation;
+
+	StartBarrelTrace(ShotId, Shot);
+}
+
+void UHitscanSubsystem::QueueShots(AShooterCharacter* Shooter, AWeapon* Weapon, const TArray<FHitscanShotRequest>& Shots)
+{
+	for (const FHitscanShotRequest& Request : Shots)
+	{
+		QueueShot(Shooter, Weapon, Request.SocketTransform, Request.CrosshairStart, Request.CrosshairEnd);
+	}
+}
+
+void UHitscanSubsystem::StartBarrelTrace(uint32 ShotId, FHitscanShot& Shot)
+{
+	// Same trace as AShooterCharacter::GetBeamEndLocation
+	const FVector WeaponTraceStart{ Shot.SocketTransform.GetLocation() };
+	const FVector StartToEnd{ Shot.BeamEndLocation - WeaponTraceStart };
+	const FVector WeaponTraceEnd{ WeaponTraceStart + StartToEnd * 1.25f };
+
+	Shot.Stage = EHitscanStage::EHS_Barrel;
+
+	GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single,
+		WeaponTraceStart,
+		WeaponTraceEnd,
+		ECollisionChannel::ECC_Visibility,
+		FCollisionQueryParams::DefaultQueryParam,
+		FCollisionResponseParams::DefaultResponseParam,
+		&TraceDelegate,
+		ShotId);
+}
+
+void UHitscanSubsystem::OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Data)
+{
+	FHitscanShot* Shot = PendingShots.Find(Data.UserData);
+	if (Shot == nullptr) return;
+
+	Shot->HitResult = Data.OutHits.Num() > 0 ? Data.OutHits[0] : FHitResult();
+	CompletedShots.Add(Data.UserData);
+}
+
+void UHitscanSubsystem::Tick(float DeltaTime)
+{
+	if (CompletedShots.Num() == 0) return;
+
+	// Resolve everything that came back this frame in one pass
+	TArray<uint32> ShotsToResolve = MoveTemp(CompletedShots);
+	CompletedShots.Reset();
+
+	for (const uint32 ShotId : ShotsToResolve)
+	{
+		FHitscanShot* Shot = PendingShots.Find(ShotId);
+		if (Shot == nullptr) continue;
+
+		if (Shot->Stage == EHitscanStage::EHS_Crosshair)
+		{
+			// Tentative beam location, still need to trace from the gun
+			if (Shot->HitResult.bBlockingHit)
+			{
+				Shot->BeamEndLocation = Shot->HitResult.Location;
+			}
+			StartBarrelTrace(ShotId, *Shot);
+			continue;
+		}
+
+		AShooterCharacter* Shooter = Shot->Shooter.Get();
+		if (Shooter && Shot->HitResult.bBlockingHit)
+		{
+			Shooter->ApplyBulletHit(Shot->BulletDamage, Shot->SocketTransform, Shot->HitResult);
+		}
+		PendingShots.Remove(ShotId);
+	}
+}
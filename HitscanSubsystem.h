@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "Weapon.h"
+#include "HitscanSubsystem.generated.h"
+
+class AShooterCharacter;
+class AWeapon;
+
+/* Which trace a queued shot is waiting on*/
+enum class EHitscanStage : uint8
+{
+	EHS_Crosshair,
+	EHS_Barrel
+};
+
+/* A shot waiting on async trace results*/
+struct FHitscanShot
+{
+	TWeakObjectPtr<AShooterCharacter> Shooter;
+
+	/* Damage of the weapon when the shot was fired*/
+	FBulletDamage BulletDamage;
+
+	/* Barrel socket transform at the time the shot was fired*/
+	FTransform SocketTransform;
+
+	/* Where the beam ends if the barrel trace is clear. Starts as the end of the crosshair ray*/
+	FVector BeamEndLocation;
+
+	EHitscanStage Stage;
+
+	FHitResult HitResult;
+};
+
+/* One shot of a batch: where the barrel was and which way the crosshair pointed*/
+struct FHitscanShotRequest
+{
+	FTransform SocketTransform;
+
+	FVector CrosshairStart;
+
+	FVector CrosshairEnd;
+};
+
+/**
+ * Resolves hitscan shots through the async trace API.
+ * Shots queued during a frame are traced off the game thread and handed back
+ * to their shooter in one batch when the results come in.
+ */
+UCLASS()
+class SHOOTER_API UHitscanSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/* Queue a shot that still needs its crosshair trace*/
+	void QueueShot(AShooterCharacter* Shooter, AWeapon* Weapon, const FTransform& SocketTransform, const FVector& CrosshairStart, const FVector& CrosshairEnd);
+
+	/* Queue a shot whose crosshair location is already known; only the barrel trace is made*/
+	void QueueShotToTarget(AShooterCharacter* Shooter, AWeapon* Weapon, const FTransform& SocketTransform, const FVector& BeamEndLocation);
+
+	/* Queue several shots fired in the same frame. Their traces go out together in one batch*/
+	void QueueShots(AShooterCharacter* Shooter, AWeapon* Weapon, const TArray<FHitscanShotRequest>& Shots);
+
+private:
+
+	/* Called by the world when an async trace finishes*/
+	void OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Data);
+
+	/* Start the trace from the barrel towards BeamEndLocation*/
+	void StartBarrelTrace(uint32 ShotId, FHitscanShot& Shot);
+
+	/* Shots waiting on a trace, keyed by the id passed as trace user data*/
+	TMap<uint32, FHitscanShot> PendingShots;
+
+	/* Shots whose trace came back since the last tick*/
+	TArray<uint32> CompletedShots;
+
+	uint32 NextShotId;
+
+	FTraceDelegate TraceDelegate;
+};
@@ -4,13 +4,18 @@
 #include "Item.h"
 #include "Components/BoxComponent.h"
 #include "Components/SkeletalMeshComponent.h"
-#include "Components/WidgetComponent.h"
 #include "Components/SphereComponent.h"
 #include "ShooterCharacter.h"
 #include "Camera/CameraComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Sound/SoundCue.h"
 #include "Curves/CurveVector.h"
+#include "ShooterDataRegistry.h"
+#include "Shooter.h"
+#include "PickupIndexSubsystem.h"
+#include "PickupInstanceSubsystem.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ticking items"), STAT_TickingItems, STATGROUP_Shooter);
 
 // Sets default values
 AItem::AItem() :
@@ -22,13 +27,9 @@ AItem::AItem() :
 
 	// Item interp variables
 	ZCurveTime(0.7f),
-	ItemInterpStartLocation(FVector(0.f)),
 	CameraTargetLocation(FVector(0.f)),
 	bInterping(false),
 
-	//ItemInterpX(0.f),
-	//ItemInterpY(0.f)
-	InterpIntialYawOffset(0.f),
 	ItemType(EItemType::EIT_MAX),
 	InterpLocIndex(0),
 	MaterialIndex(0),
@@ -38,14 +39,21 @@ AItem::AItem() :
 	GlowAmount(150.f),
 	FresnelExponent(3.0f),
 	FresnelReflectFraction(4.0f),
-	PulseCurveTime(5.f),
 
 	SlotIndex(0),
-	bCharacterInventoryFull(false)
+	MaxStackSize(1),
+	bCharacterInventoryFull(false),
+	NearbyPlayerCount(0),
+	bTickEnabled(false),
+	bInPool(false),
+	InstanceMesh(nullptr),
+	bInstanceWhenIdle(false)
 
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+	// Interps, pulses and pickup checks all run elsewhere; only subclasses with per-frame work tick
+	PrimaryActorTick.bCanEverTick = false;
+	// and then only while ShouldTick says so
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 	ItemMesh = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("ItemMesh"));
 	SetRootComponent(ItemMesh);
@@ -55,9 +63,6 @@ AItem::AItem() :
 	CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 	CollisionBox->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block);
 
-	PickupWidget = CreateDefaultSubobject<UWidgetComponent>(TEXT("PickupWidget"));
-	PickupWidget->SetupAttachment(GetRootComponent());
-
 	AreaSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AreaSphere"));
 	AreaSphere->SetupAttachment(GetRootComponent());
 
@@ -68,70 +73,146 @@ void AItem::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// Hide PickupWidget
-	if (PickupWidget)
-	{
-		PickupWidget->SetVisibility(false);
-	}
-
 	//Set active stars based on rarity
 	SetActiveStars();
 
-	// Setup overlap for area sphere
-	AreaSphere->OnComponentBeginOverlap.AddDynamic(this, &AItem::OnSphereOverlap);
-	AreaSphere->OnComponentEndOverlap.AddDynamic(this, &AItem::OnSphereEndOverlap);
-
 	//set item properties based on item state
 	SetItemProperties(ItemState);
 	
 	/* Set custom depth to disabled*/
 	InitializeCustomDepth();
 
-	StartPulseTimer();
-}
+	UpdateTickState();
+	UpdatePickupIndexRegistration();
 
-void AItem::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, 
-		AActor* OtherActor, 
-		UPrimitiveComponent* OtherComp, 
-		int32 OtherBodyIndex, 
-		bool bFromSweep, 
-		const FHitResult& SweepResult)
-{
-	if (OtherActor)
+	if (bInstanceWhenIdle)
 	{
-		AShooterCharacter* ShooterCharacter = Cast<AShooterCharacter>(OtherActor);
-		if (ShooterCharacter)
+		if (UPickupInstanceSubsystem* PickupInstances = GetWorld()->GetSubsystem<UPickupInstanceSubsystem>())
 		{
-			ShooterCharacter->IncrementOverlappedItemCount(1);
+			// Parks this actor; it comes back from the pool when a player walks up
+			PickupInstances->DemoteItem(this);
 		}
 	}
 }
 
-void AItem::OnSphereEndOverlap(UPrimitiveComponent* OverlappedComponent,
-		AActor* OtherActor, 
-		UPrimitiveComponent* OtherComp,
-		int32 OtherBodyIndex)
+void AItem::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	if (OtherActor)
+	// The character's interp batch must not outlive the item
+	if (bInterping && Character)
 	{
-		AShooterCharacter* ShooterCharacter = Cast<AShooterCharacter>(OtherActor);
-		if (ShooterCharacter)
-		{
-			ShooterCharacter->IncrementOverlappedItemCount(-1);
-			ShooterCharacter->UnhighlightInventorySlot();
-		}
+		Character->CancelItemInterp(this);
 	}
+	bInterping = false;
+
+	if (UPickupIndexSubsystem* PickupIndex = GetWorld()->GetSubsystem<UPickupIndexSubsystem>())
+	{
+		PickupIndex->UnregisterItem(this);
+	}
+
+	if (bTickEnabled)
+	{
+		bTickEnabled = false;
+		DEC_DWORD_STAT(STAT_TickingItems);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
-/** cycles through array and sets to false*/
-void AItem::SetActiveStars()
+bool AItem::ShouldTick() const
 {
-	// the zero element isn't used
-	for (int32 i = 0; i <=5; i++)
+	return false;
+}
+
+void AItem::UpdateTickState()
+{
+	if (!PrimaryActorTick.bCanEverTick || !HasActorBegunPlay()) return;
+
+	const bool bShouldTick{ ShouldTick() };
+	if (bShouldTick == bTickEnabled) return;
+
+	bTickEnabled = bShouldTick;
+	SetActorTickEnabled(bShouldTick);
+	if (bShouldTick)
+	{
+		INC_DWORD_STAT(STAT_TickingItems);
+	}
+	else
+	{
+		DEC_DWORD_STAT(STAT_TickingItems);
+	}
+}
+
+void AItem::SetPlayerNearby(bool bNearby)
+{
+	NearbyPlayerCount = FMath::Max(NearbyPlayerCount + (bNearby ? 1 : -1), 0);
+	OnPlayerProximityChanged();
+}
+
+void AItem::UpdatePickupIndexRegistration()
+{
+	UPickupIndexSubsystem* PickupIndex = GetWorld() ? GetWorld()->GetSubsystem<UPickupIndexSubsystem>() : nullptr;
+	if (PickupIndex == nullptr) return;
+
+	if (HasActorBegunPlay() && ItemState == EItemState::EIS_Pickup)
 	{
-		ActiveStars.Add(false);
+		// AreaSphere's radius is the pickup range
+		PickupIndex->RegisterItem(this, AreaSphere->GetScaledSphereRadius());
+	}
+	else
+	{
+		PickupIndex->UnregisterItem(this);
+	}
+}
+
+void AItem::OnReleasedToPool()
+{
+	bInPool = true;
 
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+	if (bInterping && Character)
+	{
+		Character->CancelItemInterp(this);
 	}
+	bInterping = false;
+	Character = nullptr;
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+
+	// PickedUp hides the mesh, turns off collision and leaves the pickup index
+	SetItemState(EItemState::EIS_PickedUp);
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+}
+
+void AItem::OnAcquiredFromPool(const FTransform& SpawnTransform)
+{
+	bInPool = false;
+
+	// Pooled items are always spawned from their class, so the class defaults are the starting values
+	const AItem* Defaults = GetClass()->GetDefaultObject<AItem>();
+	ItemCount = Defaults->ItemCount;
+	ItemRarity = Defaults->ItemRarity;
+	SlotIndex = Defaults->SlotIndex;
+	bCharacterInventoryFull = false;
+
+	SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::TeleportPhysics);
+
+	UpdateRarityProperties();
+	SetActiveStars();
+	ApplyItemMaterial();
+	bCanChangeCustomDepth = true;
+	InitializeCustomDepth();
+
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetItemState(Defaults->ItemState);
+}
+
+/** cycles through array and sets to false*/
+void AItem::SetActiveStars()
+{
+	// the zero element isn't used; Init keeps the allocation when a pooled item is reused
+	ActiveStars.Init(false, 6);
+
 	/** This switch case then sets the star rarity for item*/
 	switch (ItemRarity)
 	{
@@ -185,9 +266,9 @@ void AItem::SetItemProperties(EItemState State)
 			ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 			ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 
-			// Area sphere properties
-			AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
-			AreaSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);		
+			// Area sphere properties; only its radius is used, by the pickup index
+			AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
+			AreaSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 
 			//Set collision box properties
 			CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
@@ -198,7 +279,6 @@ void AItem::SetItemProperties(EItemState State)
 
 		case EItemState::EIS_Equipped :
 
-			PickupWidget->SetVisibility(false);
 			// Set mesh properties
 			ItemMesh->SetSimulatePhysics(false);
 			ItemMesh->SetEnableGravity(false);
@@ -240,8 +320,6 @@ void AItem::SetItemProperties(EItemState State)
 
 		case EItemState::EIS_EquipInterping	:
 
-			PickupWidget->SetVisibility(false);
-
 			// Set Item mesh properties
 			ItemMesh->SetSimulatePhysics(false);
 			ItemMesh->SetEnableGravity(false);
@@ -261,8 +339,6 @@ void AItem::SetItemProperties(EItemState State)
 
 		case EItemState::EIS_PickedUp :
 
-			PickupWidget->SetVisibility(false);
-
 			// Set Item mesh properties
 			ItemMesh->SetSimulatePhysics(false);
 			ItemMesh->SetEnableGravity(false);
@@ -286,17 +362,8 @@ void AItem::SetItemState(EItemState State)
 {
 	ItemState = State;
 	SetItemProperties(State);
-}
-
-// Called every frame
-void AItem::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-	//Handle item interping when in the equipinterping state
-	ItemInterp(DeltaTime);
-
-	// Get curve values from PulseCurve and set dynamic material parameters
-	UpdatePulse();
+	UpdateTickState();
+	UpdatePickupIndexRegistration();
 }
 
 void AItem::StartItemCurve(AShooterCharacter* Char, bool bForcePlaySound)
@@ -312,20 +379,14 @@ void AItem::StartItemCurve(AShooterCharacter* Char, bool bForcePlaySound)
 
 	PlayPickupSound(bForcePlaySound);
 
-	//Store intial location of the item
-	ItemInterpStartLocation = GetActorLocation();
 	bInterping = true;
 	SetItemState(EItemState::EIS_EquipInterping);
-	GetWorldTimerManager().ClearTimer(PulseTimer);
 
-	GetWorldTimerManager().SetTimer(ItemInterpTimer, this, &AItem::FinishInterping, ZCurveTime);
+	// Stop following the shared idle pulse
+	ItemMesh->SetCustomPrimitiveDataFloat(ItemPrimitiveData::PulseOverride, 1.f);
 
-	/* Get initial yaw of the camera*/
-	const double CameraRotationYaw {Character->GetFollowCamera()->GetComponentRotation().Yaw };
-	/** Get initial yaw of the item*/
-	const double ItemRotationYaw {GetActorRotation().Yaw};
-	/** Initial yaw offset between camera and itam*/
-	InterpIntialYawOffset = ItemRotationYaw - CameraRotationYaw;
+	// Weapons fly to the weapon interp location, everything else to its own slot
+	Character->StartItemInterp(this, ItemType == EItemType::EIT_Weapon ? 0 : InterpLocIndex);
 
 	bCanChangeCustomDepth = false;
 }
@@ -333,95 +394,26 @@ void AItem::StartItemCurve(AShooterCharacter* Char, bool bForcePlaySound)
 void AItem::FinishInterping()
 {	
 	bInterping = false;
-	if (Character)
-	{
-		//Subtract one from the item count for the interp location struct
-		Character->IncrementInterpLocItemCount(InterpLocIndex, -1);
-		Character->GetPickupItem(this);
 
-		Character->UnhighlightInventorySlot();
-	}
+	// Reset before handing the item over; picking up can return it to the pickup pool
 	//Set scale back to normal
 	SetActorScale3D(FVector(1.f));
 
 	DisableGlowMaterial(); //Disables the glow
+	ItemMesh->SetCustomPrimitiveDataFloat(ItemPrimitiveData::PulseOverride, 0.f);
 	bCanChangeCustomDepth = true;
 	DisableCustomDepth(); //Disables the outline of the weapon
-}
-
-void AItem::ItemInterp(float DeltaTime)
-{
-	if (!bInterping) return;
-
-	if(Character && ItemZCurve)
-	{
-		// Elapsed time since we started ItemInterpTimer
-		const float ElapsedTime = GetWorldTimerManager(). GetTimerElapsed(ItemInterpTimer);
-		//Get curve value corresponding to elapsedtime
-		const float CurveValue = ItemZCurve->GetFloatValue(ElapsedTime);
-
-		// Get the items intial location when the curve starts
-		FVector ItemLocation = ItemInterpStartLocation;
-		//Get location in front of camera
-		const FVector CameraInterpLocation{GetInterpLocation()};
-
-		// Vector from item to camera interp location. X and Y are zeroed out
-		const FVector ItemToCamera{ FVector(0.f, 0.f, (CameraInterpLocation - ItemLocation).Z)};
-		//Scale factor to multiply with CurveValue
-		const float DeltaZ = ItemToCamera.Size();
-
-		const FVector CurrentLocation{GetActorLocation()};
-
-		//Interpolated X value
-		const float InterpXValue = FMath::FInterpTo(CurrentLocation.X, CameraInterpLocation.X, DeltaTime, 30.0);
-		//Interpolated Y value
-		const float InterpYValue = FMath::FInterpTo(CurrentLocation.Y, CameraInterpLocation.Y, DeltaTime, 30.0);
-
-		// Set X and Y of ItemLocation to Interped values
-		ItemLocation.X = InterpXValue;
-		ItemLocation.Y = InterpYValue;
-
-		// Adding curve value to the Z component of the Initial location (Scaled by DeltaZ)
-		ItemLocation.Z += CurveValue * DeltaZ;
-		SetActorLocation(ItemLocation, true, nullptr, ETeleportType::TeleportPhysics);
-
-		// Camera rotation this frame
-		const FRotator CameraRotation {Character->GetFollowCamera()->GetComponentRotation()};
-		//camera rotation plus intial yaw offset
-		const FRotator ItemRotation {0.f, CameraRotation.Yaw + InterpIntialYawOffset, 0.f};
-		SetActorRotation(ItemRotation, ETeleportType::ResetPhysics);
-
-		if (ItemScaleCurve)
-		{
-			const float ScaleCurveValue = ItemScaleCurve->GetFloatValue(ElapsedTime);
-			// Scales dows the mesh (In FinishInterping it is sized up again)
-			SetActorScale3D(FVector(ScaleCurveValue, ScaleCurveValue, ScaleCurveValue));
-		}
-		
 
-	}
-}
-
-FVector AItem::GetInterpLocation()
-{
-	if (Character == nullptr) return FVector(0.f);
-
-	switch (ItemType)
+	// Pooling clears Character, so nothing below may go through this
+	AShooterCharacter* PickupCharacter = Character;
+	if (PickupCharacter)
 	{
-	case EItemType::EIT_Ammo : 
-
-		return Character->GetInterpLocation(InterpLocIndex).SceneComponent->GetComponentLocation();
-
-		break;
-
-	case EItemType::EIT_Weapon :
-
-		return Character->GetInterpLocation(0).SceneComponent->GetComponentLocation();
-
-		break;
+		//Subtract one from the item count for the interp location struct
+		PickupCharacter->IncrementInterpLocItemCount(InterpLocIndex, -1);
+		PickupCharacter->GetPickupItem(this);
 
+		PickupCharacter->UnhighlightInventorySlot();
 	}
-	return FVector();
 }
 
 void AItem::PlayPickupSound(bool bForcePlaySound)
@@ -498,45 +490,27 @@ void AItem::InitializeCustomDepth()
 //using the construction node from C++ instead of the editor
 void AItem::OnConstruction(const FTransform& Transform)
 {
-	/* Load data in the ItemRarityDataTable*/
-	FString RarityTablePath(TEXT("DataTable'/Game/_Game/DataTable/ItemRarityDataTable.ItemRarityDataTable'")); //Path to the itemraritydatatable
-	UDataTable* RarityTableObject = Cast <UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, *RarityTablePath));
-	if (RarityTableObject)
-	{
-		FItemRarityTable* RarityRow = nullptr;
-
-		switch (ItemRarity)
-		{
-		case EItemRarity::EIR_Damaged :
-
-			RarityRow = RarityTableObject->FindRow<FItemRarityTable>(FName("Damaged"), TEXT(""));
-
-			break;
-
-		case EItemRarity::EIR_Common:
-
-			RarityRow = RarityTableObject->FindRow<FItemRarityTable>(FName("Common"), TEXT(""));
-
-			break;
-
-		case EItemRarity::EIR_Uncommon:
-
-			RarityRow = RarityTableObject->FindRow<FItemRarityTable>(FName("Uncommon"), TEXT(""));
-
-			break;
-
-		case EItemRarity::EIR_Rare : 
-
-			RarityRow = RarityTableObject->FindRow<FItemRarityTable>(FName("Rare"), TEXT(""));
-
-			break;
+	UpdateRarityProperties();
+	ApplyItemMaterial();
+}
 
-		case EItemRarity::EIR_Legendary :
+void AItem::SetItemRarity(EItemRarity Rarity)
+{
+	if (Rarity == ItemRarity) return;
 
-			RarityRow = RarityTableObject->FindRow<FItemRarityTable>(FName("Legendary"), TEXT(""));
+	ItemRarity = Rarity;
+	UpdateRarityProperties();
+	SetActiveStars();
+	ApplyItemMaterial();
+}
 
-			break;
-		}
+void AItem::UpdateRarityProperties()
+{
+	/* Row for this rarity from the ItemRarityDataTable*/
+	UShooterDataRegistry* DataRegistry = UShooterDataRegistry::Get();
+	if (DataRegistry)
+	{
+		const FItemRarityTable* RarityRow = DataRegistry->GetRarityRow(ItemRarity);
 
 		if (RarityRow)
 		{
@@ -551,84 +525,33 @@ void AItem::OnConstruction(const FTransform& Transform)
 			}
 		}
 	}
-	if (MaterialInstance)
-	{
-		DynamicMaterialInstance = UMaterialInstanceDynamic::Create(MaterialInstance, this);
-		DynamicMaterialInstance->SetVectorParameterValue(TEXT("FresnelColor"), GlowColor);
-		ItemMesh->SetMaterial(MaterialIndex, DynamicMaterialInstance);
-		EnableGlowMaterial(); //Activating the glow material; happens before the game launches
-	}
 }
 
-//Setting the parameter in the in constructon in editor to 0
-void AItem::EnableGlowMaterial()
+void AItem::ApplyItemMaterial()
 {
-	if (DynamicMaterialInstance)
-	{
-		DynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowBlendAlpha"), 0); // Sets the parameter I made in the editor called GlowBlendAlpha to 0 (off)
-	}
-}
+	if (MaterialInstance == nullptr) return;
 
-//Setting the parameter in the in constructon in editor to 1
-void AItem::DisableGlowMaterial()
-{
-	if (DynamicMaterialInstance)
-	{
-		DynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowBlendAlpha"), 1);// Sets the parameter I made in the editor called GlowBlendAlpha to 1 (on)
-	}
-	
-}
+	// Same material for every item that uses it so they batch; what differs per item is primitive data
+	ItemMesh->SetMaterial(MaterialIndex, MaterialInstance);
+	ItemMesh->SetCustomPrimitiveDataVector4(ItemPrimitiveData::FresnelColor, FVector4(GlowColor));
 
+	// Scales for the pulse; set once, the pulse itself comes from the parameter collection
+	ItemMesh->SetCustomPrimitiveDataFloat(ItemPrimitiveData::GlowAmount, GlowAmount);
+	ItemMesh->SetCustomPrimitiveDataFloat(ItemPrimitiveData::FresnelExponent, FresnelExponent);
+	ItemMesh->SetCustomPrimitiveDataFloat(ItemPrimitiveData::FresnelReflectFraction, FresnelReflectFraction);
+	ItemMesh->SetCustomPrimitiveDataFloat(ItemPrimitiveData::PulseOverride, 0.f);
 
-void AItem::ResetPulseTimer()
-{
-	StartPulseTimer();
+	EnableGlowMaterial(); //Activating the glow material; happens before the game launches
 }
 
-void AItem::StartPulseTimer()
+//Setting the parameter in the in constructon in editor to 0
+void AItem::EnableGlowMaterial()
 {
-
-	if (ItemState == EItemState::EIS_Pickup)
-	{
-		GetWorldTimerManager().SetTimer(PulseTimer, this, &AItem::ResetPulseTimer, PulseCurveTime);
-	}
+	ItemMesh->SetCustomPrimitiveDataFloat(ItemPrimitiveData::GlowBlendAlpha, 0.f); // GlowBlendAlpha 0 (off)
 }
 
-
-void AItem::UpdatePulse()
+//Setting the parameter in the in constructon in editor to 1
+void AItem::DisableGlowMaterial()
 {
-	float ElapsedTime{};
-	FVector CurveValue{};
-
-	switch (ItemState)
-	{
-	case EItemState::EIS_Pickup :
-
-		if (PulseCurve)
-		{
-			ElapsedTime = GetWorldTimerManager().GetTimerElapsed(PulseTimer);
-			CurveValue = PulseCurve->GetVectorValue(ElapsedTime);
-		}
-
-		break;
-	
-	case EItemState::EIS_EquipInterping : 
-			
-		if (InterpPulseCurve)
-		{
-			ElapsedTime = GetWorldTimerManager().GetTimerElapsed(ItemInterpTimer);
-			CurveValue = InterpPulseCurve->GetVectorValue(ElapsedTime);
-		}
-
-		break;
-	}
-	if (DynamicMaterialInstance)
-	{
-		DynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowAmount"), CurveValue.X * GlowAmount);
-		DynamicMaterialInstance->SetScalarParameterValue(TEXT("FresnelExponent"), CurveValue.Y * FresnelExponent);
-		DynamicMaterialInstance->SetScalarParameterValue(TEXT("FresnelReflectFraction"), CurveValue.Z * FresnelReflectFraction);
-	}
-
+	ItemMesh->SetCustomPrimitiveDataFloat(ItemPrimitiveData::GlowBlendAlpha, 1.f); // GlowBlendAlpha 1 (on)
 }
-
-
@@ -41,6 +41,23 @@ enum class EItemType : uint8
 
 	EIT_MAX		UMETA(DisplayName = "DefaultMax")
 };
+/* Custom primitive data slots on ItemMesh read by the item material*/
+namespace ItemPrimitiveData
+{
+	/* Rarity glow color, 4 floats*/
+	constexpr int32 FresnelColor = 0;
+	/* 0 glows, 1 doesn't*/
+	constexpr int32 GlowBlendAlpha = 4;
+	/* Scales applied to the pulse*/
+	constexpr int32 GlowAmount = 5;
+	constexpr int32 FresnelExponent = 6;
+	constexpr int32 FresnelReflectFraction = 7;
+	/* 1 to use InterpPulse instead of the shared idle pulse*/
+	constexpr int32 PulseOverride = 8;
+	/* Per-item pulse while interping, 3 floats*/
+	constexpr int32 InterpPulse = 9;
+}
+
 USTRUCT(BlueprintType)
 struct FItemRarityTable : public FTableRowBase
 {
@@ -65,6 +82,22 @@ struct FItemRarityTable : public FTableRowBase
 	int32 CustomDepthStencil;
 };
 
+/* Non-weapon items of one class held in an inventory slot, with no actor behind them*/
+USTRUCT(BlueprintType)
+struct FItemStack
+{
+	GENERATED_BODY()
+
+	/* Class the items came from; null for a slot without a stack*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	TSubclassOf<class AItem> ItemClass;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Count = 0;
+
+	FORCEINLINE bool IsEmpty() const { return ItemClass == nullptr; }
+};
+
 UCLASS()
 class SHOOTER_API AItem : public AActor
 {
@@ -80,38 +113,16 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
-	/** Called when overlapping area sphere*/
-	UFUNCTION()
-	void OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, 
-		AActor* OtherActor, 
-		UPrimitiveComponent* OtherComp, 
-		int32 OtherBodyIndex, 
-		bool bFromSweep, 
-		const FHitResult& SweepResult);
-
-	/** Called when overlapping area end*/
-	UFUNCTION()
-	void OnSphereEndOverlap(UPrimitiveComponent* OverlappedComponent,
-		AActor* OtherActor, 
-		UPrimitiveComponent* OtherComp,
-		int32 OtherBodyIndex);	
-
 	/** Sets the ActiveStars array of bools based on rarity*/
 	void SetActiveStars();	
 
+	/** Copies the colors, stars and stencil for ItemRarity from the rarity table*/
+	void UpdateRarityProperties();
+
 
 	/* Sets properties of the item's state base on State*/
 	virtual void SetItemProperties(EItemState State);
 
-	/** Called when ItemInterpTimer is finished*/
-	void FinishInterping();
-
-	/** Handles item interpolation when in the equip interping state*/
-	void ItemInterp(float DeltaTime);
-
-	/* Get interp location based on the item type*/
-	FVector GetInterpLocation();
-
 	void PlayPickupSound(bool bForcePlaySound = false);
 
 	virtual void InitializeCustomDepth();
@@ -121,16 +132,24 @@ protected:
 
 	void EnableGlowMaterial();
 
-	void UpdatePulse();
+	/* Puts the shared MaterialInstance on the mesh and writes the per-item custom primitive data*/
+	void ApplyItemMaterial();
 
-	void ResetPulseTimer();
+	/** Called when a player enters or leaves pickup range*/
+	virtual void OnPlayerProximityChanged() {}
 
-	void StartPulseTimer();
+	/** Keeps the item in the pickup index while it is lying in the world as a pickup*/
+	void UpdatePickupIndexRegistration();
 
-public:	
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
+	/** True while the item has per-frame work. A plain item never does; subclasses that can tick override this*/
+	virtual bool ShouldTick() const;
+
+	/** Turns ticking on or off to match ShouldTick. Call whenever something ShouldTick reads changes*/
+	void UpdateTickState();
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:	
 	//Called in AShootercharacter::GetPickupItem
 	void PlayEquipSound(bool bForcePlaySound = false);
 
@@ -144,10 +163,6 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = true))
 	class UBoxComponent* CollisionBox;
 
-	/** Popup widget for when player looks at item*/
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = true))
-	class UWidgetComponent* PickupWidget;
-
 	/** Enables item tracing when overlap*/
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = true))
 	class USphereComponent* AreaSphere;
@@ -175,10 +190,6 @@ private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = true))
 	class UCurveFloat* ItemZCurve;
 
-	/** Starting location when interping begins*/
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = true))
-	FVector ItemInterpStartLocation;
-
 	/** Target interp location in front of the camera*/
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = true))
 	FVector CameraTargetLocation;
@@ -187,9 +198,7 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = true))
 	bool bInterping;
 
-	/** plays when we start interping*/
-	FTimerHandle ItemInterpTimer;
-	/** Duration of the curve and timer*/
+	/** Duration of the interp curves*/
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = true))
 	float ZCurveTime;
 
@@ -197,13 +206,6 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = true))
 	class AShooterCharacter* Character;
 
-	/** X and Y for the Item while interping in the EquipInterpingState*/
-	//float ItemInterpX;
-	//float ItemInterpY;
-
-	/** Initial yaw offset between the camera and the interping item*/
-	float InterpIntialYawOffset;
-
 	/** Curve used to scale the item when interping*/
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = true))
 	UCurveFloat* ItemScaleCurve;
@@ -228,29 +230,15 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Properties", meta = (AllowPrivateAccess = true))
 	int32 MaterialIndex;
 
-	/* Dynamic instance that we can change at runtime*/
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = true))
-	UMaterialInstanceDynamic* DynamicMaterialInstance;
-
-	/* Material instance used with the dynamic material instance*/
+	/* Material instance shared by every item using it; per-item values go through custom primitive data*/
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Properties", meta = (AllowPrivateAccess = true))
 	UMaterialInstance* MaterialInstance;
 	
 	bool bCanChangeCustomDepth;
 
-	/* Curve to drive the dynamic material parameter*/
+	/* Curve to drive the material pulse while interping*/
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = true))
-	class UCurveVector* PulseCurve;
-
-	/* Curve to drive the dynamic material parameter*/
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = true))
-	UCurveVector* InterpPulseCurve;
-
-	FTimerHandle PulseTimer;
-
-	/* time for the pulsetimer*/
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = true))
-	float PulseCurveTime;
+	class UCurveVector* InterpPulseCurve;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = true))
 	float GlowAmount;
@@ -273,10 +261,23 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory", meta = (AllowPrivateAccess = true))
 	int32 SlotIndex;
 
+	/* Most of this item one inventory slot can stack. Weapons and ammo don't use stacks*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Inventory", meta = (AllowPrivateAccess = true, ClampMin = 1))
+	int32 MaxStackSize;
+
 	/* True when the character's inventory is full*/
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory", meta = (AllowPrivateAccess = true))
 	bool bCharacterInventoryFull;
 
+	/** Players within AreaSphere's radius, from the pickup index*/
+	int32 NearbyPlayerCount;
+
+	/** True while counted in STAT_TickingItems*/
+	bool bTickEnabled;
+
+	/** True while parked in UPickupPoolSubsystem*/
+	bool bInPool;
+
 	/* Item Rarity Data Table*/
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Data Table", meta = (AllowPrivateAccess = true))
 	class UDataTable* ItemRarityDataTable;
@@ -300,15 +301,25 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Rarity", meta = (AllowPrivateAccess = true))
 	UTexture2D* IconBackground;
 
-public:		
-	FORCEINLINE UWidgetComponent* GetPickupWidget() const { return PickupWidget ;}
+	/* Static mesh drawn while the pickup is an instance; items without one always stay actors*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Instancing", meta = (AllowPrivateAccess = true))
+	class UStaticMesh* InstanceMesh;
 
+	/* Hand this pickup to UPickupInstanceSubsystem when play begins and keep it an instance while no player is near*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Instancing", meta = (AllowPrivateAccess = true))
+	bool bInstanceWhenIdle;
+
+public:		
 	FORCEINLINE USphereComponent* GetAreaSphere() const {return AreaSphere; }
 
 	FORCEINLINE UBoxComponent* GetCollisionBox() const {return CollisionBox; }
 
 	FORCEINLINE EItemState GetItemState() const {return ItemState; }
 
+	FORCEINLINE int32 GetNearbyPlayerCount() const { return NearbyPlayerCount; }
+
+	FORCEINLINE bool IsInPool() const { return bInPool; }
+
 	FORCEINLINE USoundCue* GetPickupSound() const { return PickupSound;  }
 
 	FORCEINLINE USoundCue* GetEquipSound() const { return EquipSound; }
@@ -316,8 +327,28 @@ public:
 	FORCEINLINE USkeletalMeshComponent* GetItemMesh() const { return ItemMesh; }
 
 	FORCEINLINE int32 GetSlotIndex() const { return SlotIndex;  }
+	FORCEINLINE int32 GetMaxStackSize() const { return MaxStackSize; }
 
 	FORCEINLINE int32 GetItemCount() const { return ItemCount; }
+
+	FORCEINLINE EItemRarity GetItemRarity() const { return ItemRarity; }
+
+	/** Changes rarity and refreshes the colors, stars and material that depend on it*/
+	void SetItemRarity(EItemRarity Rarity);
+
+	FORCEINLINE void SetItemCount(int32 Count) { ItemCount = Count; }
+
+	FORCEINLINE const FString& GetItemName() const { return ItemName; }
+
+	FORCEINLINE const TArray<bool>& GetActiveStars() const { return ActiveStars; }
+
+	FORCEINLINE UTexture2D* GetAmmoIcon() const { return AmmoIcon; }
+
+	FORCEINLINE FLinearColor GetLightColor() const { return LightColor; }
+
+	FORCEINLINE FLinearColor GetDarkColor() const { return DarkColor; }
+
+	FORCEINLINE bool IsCharacterInventoryFull() const { return bCharacterInventoryFull; }
 	
 	FORCEINLINE void SetCharacter(AShooterCharacter* Char) { Character = Char; }
 
@@ -340,10 +371,6 @@ public:
 
 	FORCEINLINE UMaterialInstance* GetMaterialInstance() const { return MaterialInstance;  }
 
-	FORCEINLINE UMaterialInstanceDynamic* GetDynamicMaterialInstance() const { return DynamicMaterialInstance; }
-
-	FORCEINLINE void SetDynamicMaterialInstance(UMaterialInstanceDynamic* Instance) { DynamicMaterialInstance = Instance;  }
-
 	FORCEINLINE FLinearColor GetGlowColor() const { return GlowColor;}
 
 	FORCEINLINE int32 GetMaterialIndex() const { return MaterialIndex;  }
@@ -352,9 +379,32 @@ public:
 
 	void SetItemState(EItemState State);
 
+	/** Called by the pickup index when a player comes into or goes out of range*/
+	void SetPlayerNearby(bool bNearby);
+
+	/** Called by the pickup pool: hides the item, drops its collision, timers and pickup index entry*/
+	virtual void OnReleasedToPool();
+
+	/** Called by the pickup pool: brings the item back at SpawnTransform with its class defaults*/
+	virtual void OnAcquiredFromPool(const FTransform& SpawnTransform);
+
+	/** Mesh UPickupInstanceSubsystem draws this item with, or null if it can't be instanced*/
+	virtual UStaticMesh* GetInstanceMesh() const { return InstanceMesh; }
+
 	/** Called from the AShooterCharacter class*/
 	void StartItemCurve(AShooterCharacter* Char, bool bForcePlaySound = false);
 
+	/** Called by the character's interp batch once the item reaches its interp location*/
+	void FinishInterping();
+
+	FORCEINLINE UCurveFloat* GetItemZCurve() const { return ItemZCurve; }
+
+	FORCEINLINE UCurveFloat* GetItemScaleCurve() const { return ItemScaleCurve; }
+
+	FORCEINLINE UCurveVector* GetInterpPulseCurve() const { return InterpPulseCurve; }
+
+	FORCEINLINE float GetZCurveTime() const { return ZCurveTime; }
+
 	virtual void EnableCustomDepth();
 
 	virtual void DisableCustomDepth();
@@ -0,0 +1,185 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemInterpBatch.h"
+#include "Item.h"
+#include "Curves/CurveFloat.h"
+#include "Curves/CurveVector.h"
+#include "Components/SkeletalMeshComponent.h"
+
+void FItemInterpBatch::Add(AItem* Item, int32 InterpLocIndex, double CameraYaw)
+{
+	if (Item == nullptr || Items.IndexOfByKey(Item) != INDEX_NONE) return;
+
+	const FVector Location{ Item->GetActorLocation() };
+
+	Items.Add(Item);
+	InterpLocIndices.Add(InterpLocIndex);
+	ZCurves.Add(FindOrBakeCurve(Item->GetItemZCurve()));
+	ScaleCurves.Add(FindOrBakeCurve(Item->GetItemScaleCurve()));
+	PulseCurves.Add(FindOrBakeCurve(Item->GetInterpPulseCurve()));
+	ElapsedTimes.Add(0.f);
+	Durations.Add(Item->GetZCurveTime());
+	YawOffsets.Add(static_cast<float>(Item->GetActorRotation().Yaw - CameraYaw));
+	StartLocations.Add(Location);
+	Locations.Add(Location);
+	Scales.Add(static_cast<float>(Item->GetActorScale3D().X));
+}
+
+void FItemInterpBatch::Remove(AItem* Item)
+{
+	const int32 Index{ Items.IndexOfByKey(Item) };
+	if (Index != INDEX_NONE)
+	{
+		RemoveAt(Index);
+	}
+}
+
+void FItemInterpBatch::RemoveAt(int32 Index)
+{
+	Items.RemoveAtSwap(Index, 1, false);
+	InterpLocIndices.RemoveAtSwap(Index, 1, false);
+	ZCurves.RemoveAtSwap(Index, 1, false);
+	ScaleCurves.RemoveAtSwap(Index, 1, false);
+	PulseCurves.RemoveAtSwap(Index, 1, false);
+	ElapsedTimes.RemoveAtSwap(Index, 1, false);
+	Durations.RemoveAtSwap(Index, 1, false);
+	YawOffsets.RemoveAtSwap(Index, 1, false);
+	StartLocations.RemoveAtSwap(Index, 1, false);
+	Locations.RemoveAtSwap(Index, 1, false);
+	Scales.RemoveAtSwap(Index, 1, false);
+}
+
+void FItemInterpBatch::Update(float DeltaTime, const TArray<FVector>& SlotLocations, double CameraYaw)
+{
+	for (int32 i = Items.Num() - 1; i >= 0; i--)
+	{
+		if (!Items[i].IsValid())
+		{
+			RemoveAt(i);
+		}
+	}
+	if (Items.Num() == 0) return;
+
+	const int32 NumItems{ Items.Num() };
+	Transforms.Reset(NumItems);
+	Pulses.Reset(NumItems);
+	FinishedItems.Reset();
+
+	// All the math first, touching nothing but the arrays
+	for (int32 i = 0; i < NumItems; i++)
+	{
+		ElapsedTimes[i] += DeltaTime;
+		const float Time{ FMath::Min(ElapsedTimes[i], Durations[i]) };
+
+		const FVector& Start{ StartLocations[i] };
+		const FVector Target{ SlotLocations.IsValidIndex(InterpLocIndices[i]) ? SlotLocations[InterpLocIndices[i]] : Start };
+
+		// X and Y chase the slot; Z follows the curve scaled by the height to climb
+		FVector& Location = Locations[i];
+		Location.X = FMath::FInterpTo(Location.X, Target.X, DeltaTime, 30.f);
+		Location.Y = FMath::FInterpTo(Location.Y, Target.Y, DeltaTime, 30.f);
+		const float ZCurveValue{ ZCurves[i] != INDEX_NONE ? Sample(FloatCurves[ZCurves[i]], Time) : 0.f };
+		Location.Z = Start.Z + ZCurveValue * FMath::Abs(Target.Z - Start.Z);
+
+		const FRotator Rotation{ 0.f, static_cast<float>(CameraYaw) + YawOffsets[i], 0.f };
+		const float Scale{ ScaleCurves[i] != INDEX_NONE ? Sample(FloatCurves[ScaleCurves[i]], Time) : Scales[i] };
+		Transforms.Add(FTransform(Rotation, Location, FVector(Scale)));
+
+		Pulses.Add(PulseCurves[i] != INDEX_NONE ? Sample(VectorCurves[PulseCurves[i]], Time) : FVector::ZeroVector);
+
+		if (ElapsedTimes[i] >= Durations[i])
+		{
+			FinishedItems.Add(Items[i]);
+		}
+	}
+
+	// Then one unswept transform per item; these moves are cosmetic
+	for (int32 i = 0; i < NumItems; i++)
+	{
+		AItem* Item = Items[i].Get();
+		Item->GetRootComponent()->SetWorldTransform(Transforms[i], false, nullptr, ETeleportType::TeleportPhysics);
+		if (PulseCurves[i] != INDEX_NONE)
+		{
+			Item->GetItemMesh()->SetCustomPrimitiveDataVector3(ItemPrimitiveData::InterpPulse, Pulses[i]);
+		}
+	}
+
+	// Finishing one pickup can end another's play, so check each again
+	for (const TWeakObjectPtr<AItem>& FinishedItem : FinishedItems)
+	{
+		AItem* Item = FinishedItem.Get();
+		if (Item == nullptr) continue;
+
+		Remove(Item);
+		Item->FinishInterping();
+	}
+}
+
+int32 FItemInterpBatch::FindOrBakeCurve(const UCurveFloat* Curve)
+{
+	if (Curve == nullptr) return INDEX_NONE;
+
+	if (const int32* Index = FloatCurveIndices.Find(Curve))
+	{
+		return *Index;
+	}
+
+	const int32 NumSamples{ FMath::Max(SamplesPerCurve, 2) };
+	float MaxTime;
+	FBakedFloatCurve Baked;
+	Curve->GetTimeRange(Baked.MinTime, MaxTime);
+	Baked.TimeToSample = MaxTime > Baked.MinTime ? (NumSamples - 1) / (MaxTime - Baked.MinTime) : 0.f;
+
+	Baked.Samples.SetNumUninitialized(NumSamples);
+	for (int32 i = 0; i < NumSamples; i++)
+	{
+		const float Time{ Baked.TimeToSample > 0.f ? Baked.MinTime + i / Baked.TimeToSample : Baked.MinTime };
+		Baked.Samples[i] = Curve->GetFloatValue(Time);
+	}
+
+	const int32 Index{ FloatCurves.Add(MoveTemp(Baked)) };
+	FloatCurveIndices.Add(Curve, Index);
+	return Index;
+}
+
+int32 FItemInterpBatch::FindOrBakeCurve(const UCurveVector* Curve)
+{
+	if (Curve == nullptr) return INDEX_NONE;
+
+	if (const int32* Index = VectorCurveIndices.Find(Curve))
+	{
+		return *Index;
+	}
+
+	const int32 NumSamples{ FMath::Max(SamplesPerCurve, 2) };
+	float MaxTime;
+	FBakedVectorCurve Baked;
+	Curve->GetTimeRange(Baked.MinTime, MaxTime);
+	Baked.TimeToSample = MaxTime > Baked.MinTime ? (NumSamples - 1) / (MaxTime - Baked.MinTime) : 0.f;
+
+	Baked.Samples.SetNumUninitialized(NumSamples);
+	for (int32 i = 0; i < NumSamples; i++)
+	{
+		const float Time{ Baked.TimeToSample > 0.f ? Baked.MinTime + i / Baked.TimeToSample : Baked.MinTime };
+		Baked.Samples[i] = Curve->GetVectorValue(Time);
+	}
+
+	const int32 Index{ VectorCurves.Add(MoveTemp(Baked)) };
+	VectorCurveIndices.Add(Curve, Index);
+	return Index;
+}
+
+float FItemInterpBatch::Sample(const FBakedFloatCurve& Curve, float Time)
+{
+	const float Position{ FMath::Clamp((Time - Curve.MinTime) * Curve.TimeToSample, 0.f, static_cast<float>(Curve.Samples.Num() - 1)) };
+	const int32 Index{ FMath::Min(FMath::FloorToInt(Position), Curve.Samples.Num() - 2) };
+	return FMath::Lerp(Curve.Samples[Index], Curve.Samples[Index + 1], Position - Index);
+}
+
+FVector FItemInterpBatch::Sample(const FBakedVectorCurve& Curve, float Time)
+{
+	const float Position{ FMath::Clamp((Time - Curve.MinTime) * Curve.TimeToSample, 0.f, static_cast<float>(Curve.Samples.Num() - 1)) };
+	const int32 Index{ FMath::Min(FMath::FloorToInt(Position), Curve.Samples.Num() - 2) };
+	return FMath::Lerp(Curve.Samples[Index], Curve.Samples[Index + 1], Position - Index);
+}
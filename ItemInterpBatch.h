@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AItem;
+class UCurveFloat;
+class UCurveVector;
+
+/* A float curve sampled at even steps across its time range*/
+struct FBakedFloatCurve
+{
+	float MinTime = 0.f;
+	float TimeToSample = 0.f;
+	TArray<float> Samples;
+};
+
+/* A vector curve sampled at even steps across its time range*/
+struct FBakedVectorCurve
+{
+	float MinTime = 0.f;
+	float TimeToSample = 0.f;
+	TArray<FVector> Samples;
+};
+
+/**
+ * Every pickup one character is pulling toward the camera.
+ * Interps are kept as parallel arrays, curves are read from baked lookup tables, and
+ * each item gets one unswept transform update per frame after all the math is done.
+ */
+struct SHOOTER_API FItemInterpBatch
+{
+public:
+
+	/* Starts pulling Item toward InterpLocIndex; the item's yaw is kept relative to CameraYaw*/
+	void Add(AItem* Item, int32 InterpLocIndex, double CameraYaw);
+
+	/* Drops Item without finishing it*/
+	void Remove(AItem* Item);
+
+	/**
+	 * Advances every interp by DeltaTime and moves the items.
+	 * @param SlotLocations World location of each interp location this frame
+	 */
+	void Update(float DeltaTime, const TArray<FVector>& SlotLocations, double CameraYaw);
+
+	FORCEINLINE int32 Num() const { return Items.Num(); }
+
+	/* Samples taken from each curve when it is first baked*/
+	int32 SamplesPerCurve = 64;
+
+private:
+
+	void RemoveAt(int32 Index);
+
+	int32 FindOrBakeCurve(const UCurveFloat* Curve);
+
+	int32 FindOrBakeCurve(const UCurveVector* Curve);
+
+	static float Sample(const FBakedFloatCurve& Curve, float Time);
+
+	static FVector Sample(const FBakedVectorCurve& Curve, float Time);
+
+	/* Per interp, all indexed together. Weak, since the batch lives outside the garbage collector's view*/
+	TArray<TWeakObjectPtr<AItem>> Items;
+	TArray<int32> InterpLocIndices;
+	TArray<int32> ZCurves;
+	TArray<int32> ScaleCurves;
+	TArray<int32> PulseCurves;
+	TArray<float> ElapsedTimes;
+	TArray<float> Durations;
+	TArray<float> YawOffsets;
+	TArray<FVector> StartLocations;
+	TArray<FVector> Locations;
+	TArray<float> Scales;
+
+	/* Scratch for this frame's results*/
+	TArray<FTransform> Transforms;
+	TArray<FVector> Pulses;
+	TArray<TWeakObjectPtr<AItem>> FinishedItems;
+
+	TArray<FBakedFloatCurve> FloatCurves;
+	TMap<TWeakObjectPtr<const UCurveFloat>, int32> FloatCurveIndices;
+
+	TArray<FBakedVectorCurve> VectorCurves;
+	TMap<TWeakObjectPtr<const UCurveVector>, int32> VectorCurveIndices;
+};
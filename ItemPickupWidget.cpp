@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemPickupWidget.h"
+#include "Item.h"
+
+void UItemPickupWidget::SetItem(AItem* NewItem)
+{
+	Item = NewItem;
+	if (Item)
+	{
+		ItemName = Item->GetItemName();
+		ItemCount = Item->GetItemCount();
+		ActiveStars = Item->GetActiveStars();
+		AmmoIcon = Item->GetAmmoIcon();
+		LightColor = Item->GetLightColor();
+		DarkColor = Item->GetDarkColor();
+		bCharacterInventoryFull = Item->IsCharacterInventoryFull();
+	}
+	OnItemChanged();
+}
+
+void UItemPickupWidget::SetCharacterInventoryFull(bool bFull)
+{
+	if (bCharacterInventoryFull == bFull) return;
+
+	bCharacterInventoryFull = bFull;
+	OnItemChanged();
+}
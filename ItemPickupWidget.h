@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "ItemPickupWidget.generated.h"
+
+class AItem;
+
+/**
+ * Base class for the pickup popup each local player shares between every item.
+ * SetItem copies the focused item's values; the Blueprint child redraws in OnItemChanged.
+ */
+UCLASS()
+class SHOOTER_API UItemPickupWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+
+	/* Retargets the widget to Item and copies its name, count, stars and icons*/
+	void SetItem(AItem* NewItem);
+
+	/* Updates the inventory full warning without retargeting*/
+	void SetCharacterInventoryFull(bool bFull);
+
+protected:
+
+	/* Called after SetItem or SetCharacterInventoryFull changed what should be shown*/
+	UFUNCTION(BlueprintImplementableEvent)
+	void OnItemChanged();
+
+private:
+
+	/* Item the widget is showing*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pickup", meta = (AllowPrivateAccess = true))
+	AItem* Item;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pickup", meta = (AllowPrivateAccess = true))
+	FString ItemName;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pickup", meta = (AllowPrivateAccess = true))
+	int32 ItemCount;
+
+	/* One per star; the zero element isn't used*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pickup", meta = (AllowPrivateAccess = true))
+	TArray<bool> ActiveStars;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pickup", meta = (AllowPrivateAccess = true))
+	UTexture2D* AmmoIcon;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pickup", meta = (AllowPrivateAccess = true))
+	FLinearColor LightColor;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pickup", meta = (AllowPrivateAccess = true))
+	FLinearColor DarkColor;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pickup", meta = (AllowPrivateAccess = true))
+	bool bCharacterInventoryFull;
+};
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemPulseSubsystem.h"
+#include "Curves/CurveVector.h"
+#include "Materials/MaterialParameterCollection.h"
+#include "Materials/MaterialParameterCollectionInstance.h"
+#include "Shooter.h"
+
+const FName UItemPulseSubsystem::ItemPulseParameterName(TEXT("ItemPulse"));
+
+bool UItemPulseSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UItemPulseSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	PulseCurve = Cast<UCurveVector>(PulseCurvePath.TryLoad());
+
+	UMaterialParameterCollection* Collection = Cast<UMaterialParameterCollection>(PulseParameterCollectionPath.TryLoad());
+	PulseParameters = Collection ? InWorld.GetParameterCollectionInstance(Collection) : nullptr;
+
+	// Without both, idle pickups stay at whatever the collection default is
+	if (PulseCurve == nullptr)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Item pulse curve %s failed to load; idle pickups won't pulse"), *PulseCurvePath.ToString());
+	}
+	if (PulseParameters == nullptr)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Item pulse parameter collection %s failed to load; idle pickups won't pulse"), *PulseParameterCollectionPath.ToString());
+	}
+}
+
+TStatId UItemPulseSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UItemPulseSubsystem, STATGROUP_Tickables);
+}
+
+void UItemPulseSubsystem::Tick(float DeltaTime)
+{
+	if (PulseCurve == nullptr || PulseParameters == nullptr) return;
+
+	// Every idle pickup pulses in sync, so one value covers them all
+	const float ElapsedTime{ FMath::Fmod(GetWorld()->GetTimeSeconds(), FMath::Max(PulseCurveTime, KINDA_SMALL_NUMBER)) };
+	const FVector CurveValue{ PulseCurve->GetVectorValue(ElapsedTime) };
+	PulseParameters->SetVectorParameterValue(ItemPulseParameterName, FLinearColor(CurveValue));
+}
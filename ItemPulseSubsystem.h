@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ItemPulseSubsystem.generated.h"
+
+class UCurveVector;
+class UMaterialParameterCollection;
+class UMaterialParameterCollectionInstance;
+
+/**
+ * Drives the idle glow pulse of every pickup with one material parameter collection write per frame.
+ * The item material reads ItemPulse from the collection and scales it by its own
+ * GlowAmount, FresnelExponent and FresnelReflectFraction primitive data. Items that
+ * are interping set PulseOverride and supply their own InterpPulse instead.
+ */
+UCLASS(Config = Game)
+class SHOOTER_API UItemPulseSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/* Collection vector parameter holding the curve value (X glow, Y fresnel exponent, Z reflect fraction)*/
+	static const FName ItemPulseParameterName;
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	/* Collection the item material reads the pulse from. Can be overridden in DefaultGame.ini*/
+	UPROPERTY(Config)
+	FSoftObjectPath PulseParameterCollectionPath{ TEXT("/Game/_Game/Materials/MPC_ItemPulse.MPC_ItemPulse") };
+
+	/* Curve for one pulse period; replaces the per-item PulseCurve. Can be overridden in DefaultGame.ini*/
+	UPROPERTY(Config)
+	FSoftObjectPath PulseCurvePath{ TEXT("/Game/_Game/Curves/ItemPulseCurve.ItemPulseCurve") };
+
+	/* Length of one pulse in seconds*/
+	UPROPERTY(Config)
+	float PulseCurveTime = 5.f;
+
+	UPROPERTY()
+	UCurveVector* PulseCurve;
+
+	UPROPERTY()
+	UMaterialParameterCollectionInstance* PulseParameters;
+};
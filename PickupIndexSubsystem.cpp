@@ -0,0 +1,157 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PickupIndexSubsystem.h"
+#include "Item.h"
+#include "ShooterCharacter.h"
+
+void UPickupIndexSubsystem::Deinitialize()
+{
+	Cells.Empty();
+	ItemCells.Empty();
+	PlayerNearbyItems.Empty();
+	InRangeScratch.Empty();
+
+	Super::Deinitialize();
+}
+
+FIntVector UPickupIndexSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt(Location.X / CellSize),
+		FMath::FloorToInt(Location.Y / CellSize),
+		FMath::FloorToInt(Location.Z / CellSize));
+}
+
+void UPickupIndexSubsystem::RegisterItem(AItem* Item, float PickupRadius)
+{
+	if (Item == nullptr) return;
+
+	if (ItemCells.Contains(Item))
+	{
+		UnregisterItem(Item);
+	}
+
+	FPickupIndexEntry Entry;
+	Entry.Item = Item;
+	Entry.Location = Item->GetActorLocation();
+	Entry.Radius = PickupRadius;
+
+	const FIntVector Cell{ GetCell(Entry.Location) };
+	Cells.FindOrAdd(Cell).Add(Entry);
+	ItemCells.Add(Item, Cell);
+	MaxItemRadius = FMath::Max(MaxItemRadius, PickupRadius);
+}
+
+void UPickupIndexSubsystem::UnregisterItem(AItem* Item)
+{
+	FIntVector Cell;
+	if (!ItemCells.RemoveAndCopyValue(Item, Cell)) return;
+
+	if (TArray<FPickupIndexEntry>* CellEntries = Cells.Find(Cell))
+	{
+		CellEntries->RemoveAllSwap([Item](const FPickupIndexEntry& Entry) { return Entry.Item == Item; }, false);
+		if (CellEntries->Num() == 0)
+		{
+			Cells.Remove(Cell);
+		}
+	}
+
+	// Out of the index means out of everyone's range
+	for (auto& PlayerPair : PlayerNearbyItems)
+	{
+		if (PlayerPair.Value.Remove(Item) > 0)
+		{
+			Item->SetPlayerNearby(false);
+		}
+	}
+}
+
+template<typename VisitorType>
+void UPickupIndexSubsystem::ForEachItemInRange(const FVector& Location, VisitorType&& Visitor) const
+{
+	if (Cells.Num() == 0) return;
+
+	const FIntVector MinCell{ GetCell(Location - FVector(MaxItemRadius)) };
+	const FIntVector MaxCell{ GetCell(Location + FVector(MaxItemRadius)) };
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+			{
+				const TArray<FPickupIndexEntry>* CellEntries = Cells.Find(FIntVector(X, Y, Z));
+				if (CellEntries == nullptr) continue;
+
+				for (const FPickupIndexEntry& Entry : *CellEntries)
+				{
+					if (FVector::DistSquared(Location, Entry.Location) <= FMath::Square(Entry.Radius))
+					{
+						Visitor(Entry);
+					}
+				}
+			}
+		}
+	}
+}
+
+AItem* UPickupIndexSubsystem::FindBestPickup(const FVector& PlayerLocation, const FVector& ViewOrigin, const FVector& ViewDirection, float MinViewDot) const
+{
+	AItem* BestItem = nullptr;
+	float BestViewDot{ MinViewDot };
+
+	ForEachItemInRange(PlayerLocation, [&](const FPickupIndexEntry& Entry)
+	{
+		const FVector ToItem{ (Entry.Location - ViewOrigin).GetSafeNormal() };
+		const float ViewDot{ static_cast<float>(FVector::DotProduct(ToItem, ViewDirection)) };
+		if (ViewDot > BestViewDot)
+		{
+			BestViewDot = ViewDot;
+			BestItem = Entry.Item;
+		}
+	});
+	return BestItem;
+}
+
+void UPickupIndexSubsystem::UpdatePlayerProximity(AShooterCharacter* Player, const FVector& PlayerLocation)
+{
+	if (Player == nullptr) return;
+
+	InRangeScratch.Reset();
+	ForEachItemInRange(PlayerLocation, [this](const FPickupIndexEntry& Entry)
+	{
+		InRangeScratch.Add(Entry.Item);
+	});
+
+	TSet<TWeakObjectPtr<AItem>>& NearbyItems = PlayerNearbyItems.FindOrAdd(Player);
+	for (const TWeakObjectPtr<AItem>& Item : NearbyItems)
+	{
+		if (Item.IsValid() && !InRangeScratch.Contains(Item))
+		{
+			Item->SetPlayerNearby(false);
+		}
+	}
+	for (const TWeakObjectPtr<AItem>& Item : InRangeScratch)
+	{
+		if (!NearbyItems.Contains(Item))
+		{
+			Item->SetPlayerNearby(true);
+		}
+	}
+	Swap(NearbyItems, InRangeScratch);
+}
+
+void UPickupIndexSubsystem::RemovePlayer(AShooterCharacter* Player)
+{
+	TSet<TWeakObjectPtr<AItem>> NearbyItems;
+	if (!PlayerNearbyItems.RemoveAndCopyValue(Player, NearbyItems)) return;
+
+	for (const TWeakObjectPtr<AItem>& Item : NearbyItems)
+	{
+		if (Item.IsValid())
+		{
+			Item->SetPlayerNearby(false);
+		}
+	}
+}
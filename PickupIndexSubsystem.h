@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PickupIndexSubsystem.generated.h"
+
+class AItem;
+class AShooterCharacter;
+
+/* A pickup in the index*/
+struct FPickupIndexEntry
+{
+	AItem* Item = nullptr;
+
+	/* Item location when it was registered; pickups don't move*/
+	FVector Location = FVector::ZeroVector;
+
+	/* A player closer than this can pick the item up*/
+	float Radius = 0.f;
+};
+
+/**
+ * Uniform grid of every item lying in the world in the pickup state.
+ * Answers "which pickups are in range" and "which one is the player looking at"
+ * without overlap events or physics queries.
+ */
+UCLASS(Config = Game)
+class SHOOTER_API UPickupIndexSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	/* Adds Item at its current location, or moves it if it is already in the index*/
+	void RegisterItem(AItem* Item, float PickupRadius);
+
+	void UnregisterItem(AItem* Item);
+
+	/**
+	 * Best pickup in range of PlayerLocation inside the view cone
+	 * @param MinViewDot Cosine of the cone's half angle
+	 * @return The in-range item closest to ViewDirection, or nullptr
+	 */
+	AItem* FindBestPickup(const FVector& PlayerLocation, const FVector& ViewOrigin, const FVector& ViewDirection, float MinViewDot) const;
+
+	/* Tells items when Player comes into or goes out of their range*/
+	void UpdatePlayerProximity(AShooterCharacter* Player, const FVector& PlayerLocation);
+
+	/* Takes Player out of every item's nearby count*/
+	void RemovePlayer(AShooterCharacter* Player);
+
+	UFUNCTION(BlueprintCallable, Category = "Pickup Index")
+	FORCEINLINE int32 GetNumRegisteredItems() const { return ItemCells.Num(); }
+
+private:
+
+	FIntVector GetCell(const FVector& Location) const;
+
+	/* Calls Visitor for every entry whose radius contains Location*/
+	template<typename VisitorType>
+	void ForEachItemInRange(const FVector& Location, VisitorType&& Visitor) const;
+
+	/* Entries by grid cell*/
+	TMap<FIntVector, TArray<FPickupIndexEntry>> Cells;
+
+	/* Cell each registered item is in*/
+	TMap<const AItem*, FIntVector> ItemCells;
+
+	/* Items each player is currently in range of*/
+	TMap<TWeakObjectPtr<AShooterCharacter>, TSet<TWeakObjectPtr<AItem>>> PlayerNearbyItems;
+
+	/* Items in range of the player being updated; swapped with that player's set so neither reallocates*/
+	TSet<TWeakObjectPtr<AItem>> InRangeScratch;
+
+	/* Largest pickup radius registered; bounds how many cells a query visits*/
+	float MaxItemRadius = 0.f;
+
+	/* Edge length of a grid cell*/
+	UPROPERTY(Config)
+	float CellSize = 1000.f;
+};
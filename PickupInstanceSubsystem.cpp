@@ -0,0 +1,298 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PickupInstanceSubsystem.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/SphereComponent.h"
+#include "GameFramework/WorldSettings.h"
+#include "Item.h"
+#include "Ammo.h"
+#include "PickupPoolSubsystem.h"
+#include "Shooter.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Instanced pickups"), STAT_InstancedPickups, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Promoted pickups"), STAT_PromotedPickups, STATGROUP_Shooter);
+
+void UPickupInstanceSubsystem::Deinitialize()
+{
+	for (FPickupInstanceBatch& Batch : Batches)
+	{
+		if (IsValid(Batch.Component))
+		{
+			Batch.Component->DestroyComponent();
+		}
+	}
+	DEC_DWORD_STAT_BY(STAT_InstancedPickups, Pickups.Num() - FreePickups.Num() - PromotedPickups.Num());
+	DEC_DWORD_STAT_BY(STAT_PromotedPickups, PromotedPickups.Num());
+
+	Pickups.Empty();
+	FreePickups.Empty();
+	PromotedPickups.Empty();
+	Batches.Empty();
+	MeshBatches.Empty();
+	Cells.Empty();
+	PlayerLocations.Empty();
+
+	Super::Deinitialize();
+}
+
+FIntVector UPickupInstanceSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt(Location.X / CellSize),
+		FMath::FloorToInt(Location.Y / CellSize),
+		FMath::FloorToInt(Location.Z / CellSize));
+}
+
+int32 UPickupInstanceSubsystem::AddPickup(TSubclassOf<AItem> ItemClass, const FTransform& Transform, int32 ItemCount)
+{
+	if (ItemClass == nullptr) return INDEX_NONE;
+
+	const AItem* Defaults = ItemClass->GetDefaultObject<AItem>();
+	UStaticMesh* Mesh = Defaults->GetInstanceMesh();
+	if (Mesh == nullptr)
+	{
+		// Nothing to draw it with; it has to be a real actor
+		if (AItem* Item = UPickupPoolSubsystem::SpawnPooledItem(this, ItemClass, Transform))
+		{
+			Item->SetItemCount(ItemCount);
+		}
+		return INDEX_NONE;
+	}
+
+	const int32 PickupId{ AddPickupRecord(ItemClass, Mesh, Transform, ItemCount, Defaults->GetAreaSphere()->GetScaledSphereRadius()) };
+	ShowInstance(Pickups[PickupId]);
+	INC_DWORD_STAT(STAT_InstancedPickups);
+	return PickupId;
+}
+
+bool UPickupInstanceSubsystem::DemoteItem(AItem* Item)
+{
+	if (bPromoting || !IsValid(Item) || Item->GetItemState() != EItemState::EIS_Pickup) return false;
+
+	UStaticMesh* Mesh = Item->GetInstanceMesh();
+	if (Mesh == nullptr) return false;
+
+	const int32 PickupId{ AddPickupRecord(Item->GetClass(), Mesh, Item->GetActorTransform(), Item->GetItemCount(), Item->GetAreaSphere()->GetScaledSphereRadius()) };
+	StoreInstanceState(Pickups[PickupId], Item);
+	UPickupPoolSubsystem::DespawnPooledItem(Item);
+
+	ShowInstance(Pickups[PickupId]);
+	INC_DWORD_STAT(STAT_InstancedPickups);
+	return true;
+}
+
+int32 UPickupInstanceSubsystem::AddPickupRecord(UClass* ItemClass, UStaticMesh* Mesh, const FTransform& Transform, int32 ItemCount, float Radius)
+{
+	const int32 PickupId{ FreePickups.Num() > 0 ? FreePickups.Pop(false) : Pickups.AddDefaulted() };
+
+	FInstancedPickup& Pickup = Pickups[PickupId];
+	Pickup.ItemClass = ItemClass;
+	Pickup.Item = nullptr;
+	Pickup.Transform = Transform;
+	Pickup.ItemCount = ItemCount;
+	Pickup.Radius = Radius;
+	Pickup.BatchIndex = FindOrAddBatch(Mesh);
+
+	FPickupInstanceBatch& Batch = Batches[Pickup.BatchIndex];
+	Pickup.InstanceIndex = Batch.FreeInstances.Num() > 0
+		? Batch.FreeInstances.Pop(false)
+		: Batch.Component->AddInstance(FTransform(Transform.GetRotation(), Transform.GetLocation(), FVector::ZeroVector), true);
+
+	Cells.FindOrAdd(GetCell(Transform.GetLocation())).Add(PickupId);
+	MaxRadius = FMath::Max(MaxRadius, Radius);
+	return PickupId;
+}
+
+void UPickupInstanceSubsystem::RemovePickupRecord(int32 PickupId)
+{
+	FInstancedPickup& Pickup = Pickups[PickupId];
+
+	const FIntVector Cell{ GetCell(Pickup.Transform.GetLocation()) };
+	if (TArray<int32>* CellPickups = Cells.Find(Cell))
+	{
+		CellPickups->RemoveSwap(PickupId, false);
+		if (CellPickups->Num() == 0)
+		{
+			Cells.Remove(Cell);
+		}
+	}
+
+	// Instances are hidden rather than removed so the other indices stay put
+	HideInstance(Pickup);
+	Batches[Pickup.BatchIndex].FreeInstances.Add(Pickup.InstanceIndex);
+
+	Pickup = FInstancedPickup();
+	FreePickups.Add(PickupId);
+}
+
+void UPickupInstanceSubsystem::UpdatePlayerPromotion(AShooterCharacter* Player, const FVector& PlayerLocation)
+{
+	if (Player == nullptr) return;
+
+	PlayerLocations.Add(Player, PlayerLocation);
+
+	// Promoted pickups that were picked up leave the system; idle ones nobody is near go back to instances
+	for (int32 i = PromotedPickups.Num() - 1; i >= 0; i--)
+	{
+		const int32 PickupId{ PromotedPickups[i] };
+		AItem* Item = Pickups[PickupId].Item;
+		if (!IsValid(Item) || Item->IsInPool() || Item->GetItemState() != EItemState::EIS_Pickup)
+		{
+			PromotedPickups.RemoveAtSwap(i, 1, false);
+			DEC_DWORD_STAT(STAT_PromotedPickups);
+			RemovePickupRecord(PickupId);
+		}
+		else if (!IsAnyPlayerInRange(Item->GetActorLocation(), Pickups[PickupId].Radius * DemoteRadiusScale))
+		{
+			PromotedPickups.RemoveAtSwap(i, 1, false);
+			DemotePickup(PickupId);
+		}
+	}
+
+	if (Cells.Num() == 0) return;
+
+	const FIntVector MinCell{ GetCell(PlayerLocation - FVector(MaxRadius)) };
+	const FIntVector MaxCell{ GetCell(PlayerLocation + FVector(MaxRadius)) };
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+			{
+				const TArray<int32>* CellPickups = Cells.Find(FIntVector(X, Y, Z));
+				if (CellPickups == nullptr) continue;
+
+				for (const int32 PickupId : *CellPickups)
+				{
+					const FInstancedPickup& Pickup = Pickups[PickupId];
+					if (Pickup.Item == nullptr && FVector::DistSquared(PlayerLocation, Pickup.Transform.GetLocation()) <= FMath::Square(Pickup.Radius))
+					{
+						PromotePickup(PickupId);
+					}
+				}
+			}
+		}
+	}
+}
+
+void UPickupInstanceSubsystem::RemovePlayer(AShooterCharacter* Player)
+{
+	PlayerLocations.Remove(Player);
+}
+
+bool UPickupInstanceSubsystem::IsAnyPlayerInRange(const FVector& Location, float Radius) const
+{
+	for (const auto& PlayerPair : PlayerLocations)
+	{
+		if (PlayerPair.Key.IsValid() && FVector::DistSquared(Location, PlayerPair.Value) <= FMath::Square(Radius))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void UPickupInstanceSubsystem::PromotePickup(int32 PickupId)
+{
+	FInstancedPickup& Pickup = Pickups[PickupId];
+
+	bPromoting = true;
+	AItem* Item = UPickupPoolSubsystem::SpawnPooledItem(this, Pickup.ItemClass, Pickup.Transform);
+	bPromoting = false;
+	if (Item == nullptr) return;
+
+	ApplyInstanceState(Pickup, Item);
+	Item->SetItemCount(Pickup.ItemCount);
+	Pickup.Item = Item;
+	HideInstance(Pickup);
+
+	PromotedPickups.Add(PickupId);
+	DEC_DWORD_STAT(STAT_InstancedPickups);
+	INC_DWORD_STAT(STAT_PromotedPickups);
+}
+
+void UPickupInstanceSubsystem::DemotePickup(int32 PickupId)
+{
+	FInstancedPickup& Pickup = Pickups[PickupId];
+	AItem* Item = Pickup.Item;
+
+	// Carry over anything that changed while it was an actor
+	Pickup.ItemCount = Item->GetItemCount();
+	StoreInstanceState(Pickup, Item);
+	Pickup.Item = nullptr;
+	UPickupPoolSubsystem::DespawnPooledItem(Item);
+
+	ShowInstance(Pickup);
+	DEC_DWORD_STAT(STAT_PromotedPickups);
+	INC_DWORD_STAT(STAT_InstancedPickups);
+}
+
+void UPickupInstanceSubsystem::StoreInstanceState(FInstancedPickup& Pickup, const AItem* Item)
+{
+	Pickup.bHasInstanceState = true;
+	Pickup.ItemRarity = Item->GetItemRarity();
+
+	if (const AWeapon* Weapon = Cast<AWeapon>(Item))
+	{
+		Pickup.WeaponRecord = Weapon->MakeRecord();
+	}
+	else if (const AAmmo* Ammo = Cast<AAmmo>(Item))
+	{
+		Pickup.AmmoType = Ammo->GetAmmoType();
+	}
+}
+
+void UPickupInstanceSubsystem::ApplyInstanceState(const FInstancedPickup& Pickup, AItem* Item)
+{
+	if (!Pickup.bHasInstanceState) return;
+
+	if (AWeapon* Weapon = Cast<AWeapon>(Item))
+	{
+		// Type, rarity and ammo in one go, the same as rehydrating an inventory slot
+		Weapon->ApplyRecord(Pickup.WeaponRecord);
+		return;
+	}
+
+	Item->SetItemRarity(Pickup.ItemRarity);
+	if (AAmmo* Ammo = Cast<AAmmo>(Item))
+	{
+		Ammo->SetAmmoType(Pickup.AmmoType);
+	}
+}
+
+int32 UPickupInstanceSubsystem::FindOrAddBatch(UStaticMesh* Mesh)
+{
+	if (const int32* BatchIndex = MeshBatches.Find(Mesh))
+	{
+		return *BatchIndex;
+	}
+
+	// Same outer UEmitterPoolSubsystem uses for its world space components
+	UInstancedStaticMeshComponent* Component = NewObject<UInstancedStaticMeshComponent>(GetWorld()->GetWorldSettings());
+	Component->SetStaticMesh(Mesh);
+	Component->SetMobility(EComponentMobility::Movable);
+	Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Component->SetUsingAbsoluteLocation(true);
+	Component->SetUsingAbsoluteRotation(true);
+	Component->SetUsingAbsoluteScale(true);
+	Component->RegisterComponentWithWorld(GetWorld());
+
+	const int32 BatchIndex{ Batches.AddDefaulted() };
+	Batches[BatchIndex].Component = Component;
+	MeshBatches.Add(Mesh, BatchIndex);
+	return BatchIndex;
+}
+
+void UPickupInstanceSubsystem::ShowInstance(const FInstancedPickup& Pickup)
+{
+	Batches[Pickup.BatchIndex].Component->UpdateInstanceTransform(Pickup.InstanceIndex, Pickup.Transform, true, true, true);
+}
+
+void UPickupInstanceSubsystem::HideInstance(const FInstancedPickup& Pickup)
+{
+	// Zero scale instead of RemoveInstance, which would shift every later index
+	const FTransform HiddenTransform{ Pickup.Transform.GetRotation(), Pickup.Transform.GetLocation(), FVector::ZeroVector };
+	Batches[Pickup.BatchIndex].Component->UpdateInstanceTransform(Pickup.InstanceIndex, HiddenTransform, true, true, true);
+}
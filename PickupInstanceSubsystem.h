@@ -0,0 +1,159 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Weapon.h"
+#include "PickupInstanceSubsystem.generated.h"
+
+class AItem;
+class AShooterCharacter;
+class UInstancedStaticMeshComponent;
+class UStaticMesh;
+
+/* A pickup drawn as an instance, or promoted to an actor while a player is near it*/
+USTRUCT()
+struct FInstancedPickup
+{
+	GENERATED_BODY()
+
+	/* Class of the actor it is promoted to; null while the slot is free*/
+	UPROPERTY()
+	UClass* ItemClass = nullptr;
+
+	/* Actor standing in for the instance while promoted*/
+	UPROPERTY()
+	AItem* Item = nullptr;
+
+	FTransform Transform = FTransform::Identity;
+
+	/* ItemCount handed to the actor on promotion*/
+	int32 ItemCount = 0;
+
+	/* Per instance state of a demoted actor, put back on promotion. Pooled actors otherwise start from their class defaults*/
+	bool bHasInstanceState = false;
+
+	EItemRarity ItemRarity = EItemRarity::EIR_Common;
+
+	/* Weapon type, rarity and ammo of a demoted weapon*/
+	UPROPERTY()
+	FWeaponRecord WeaponRecord;
+
+	EAmmoType AmmoType = EAmmoType::EAT_9mm;
+
+	/* A player closer than this promotes the pickup*/
+	float Radius = 0.f;
+
+	int32 BatchIndex = INDEX_NONE;
+	int32 InstanceIndex = INDEX_NONE;
+};
+
+/* Every instance sharing one static mesh*/
+USTRUCT()
+struct FPickupInstanceBatch
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UInstancedStaticMeshComponent* Component = nullptr;
+
+	/* Zero scaled instances ready to be reused*/
+	TArray<int32> FreeInstances;
+};
+
+/**
+ * Draws idle pickups as instances of one instanced static mesh per mesh, with no actor behind them.
+ * A pickup is promoted to a pooled AItem when a player comes within its pickup range and demoted
+ * back to an instance once every player is comfortably outside it again.
+ */
+UCLASS(Config = Game)
+class SHOOTER_API UPickupInstanceSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	/**
+	 * Adds a pickup of ItemClass at Transform. Classes without an instance mesh are spawned as actors
+	 * @return Id of the instanced pickup, or INDEX_NONE if it was spawned as an actor
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Pickup Instances")
+	int32 AddPickup(TSubclassOf<AItem> ItemClass, const FTransform& Transform, int32 ItemCount);
+
+	/* Turns an idle pickup actor into an instance and parks the actor. False if it has to stay an actor*/
+	bool DemoteItem(AItem* Item);
+
+	/* Promotes pickups in range of Player and demotes the ones nobody is near any more*/
+	void UpdatePlayerPromotion(AShooterCharacter* Player, const FVector& PlayerLocation);
+
+	void RemovePlayer(AShooterCharacter* Player);
+
+	UFUNCTION(BlueprintCallable, Category = "Pickup Instances")
+	FORCEINLINE int32 GetNumPromotedPickups() const { return PromotedPickups.Num(); }
+
+private:
+
+	FIntVector GetCell(const FVector& Location) const;
+
+	/* Copies the state a pooled actor would lose into Pickup*/
+	static void StoreInstanceState(FInstancedPickup& Pickup, const AItem* Item);
+
+	/* Puts a demoted actor's state back on the actor standing in for it*/
+	static void ApplyInstanceState(const FInstancedPickup& Pickup, AItem* Item);
+
+	/* Takes a free pickup slot and puts it in the grid*/
+	int32 AddPickupRecord(UClass* ItemClass, UStaticMesh* Mesh, const FTransform& Transform, int32 ItemCount, float Radius);
+
+	/* Frees the pickup's instance and slot; its actor now belongs to whoever picked it up*/
+	void RemovePickupRecord(int32 PickupId);
+
+	void PromotePickup(int32 PickupId);
+
+	void DemotePickup(int32 PickupId);
+
+	/* True if any player is within Radius of Location*/
+	bool IsAnyPlayerInRange(const FVector& Location, float Radius) const;
+
+	int32 FindOrAddBatch(UStaticMesh* Mesh);
+
+	void ShowInstance(const FInstancedPickup& Pickup);
+
+	void HideInstance(const FInstancedPickup& Pickup);
+
+	UPROPERTY()
+	TArray<FInstancedPickup> Pickups;
+
+	/* Unused slots in Pickups*/
+	TArray<int32> FreePickups;
+
+	/* Pickups that currently have an actor*/
+	TArray<int32> PromotedPickups;
+
+	UPROPERTY()
+	TArray<FPickupInstanceBatch> Batches;
+
+	TMap<UStaticMesh*, int32> MeshBatches;
+
+	/* Pickup ids by grid cell*/
+	TMap<FIntVector, TArray<int32>> Cells;
+
+	/* Last location of every player driving promotion*/
+	TMap<TWeakObjectPtr<AShooterCharacter>, FVector> PlayerLocations;
+
+	/* Largest pickup radius added; bounds how many cells a query visits*/
+	float MaxRadius = 0.f;
+
+	/* True while a promotion spawns an actor, so its BeginPlay doesn't demote it straight back*/
+	bool bPromoting = false;
+
+	/* Edge length of a grid cell*/
+	UPROPERTY(Config)
+	float CellSize = 1000.f;
+
+	/* Players have to be this many times the pickup radius away before a promoted pickup is demoted*/
+	UPROPERTY(Config)
+	float DemoteRadiusScale = 1.25f;
+};
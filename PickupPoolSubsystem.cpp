@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PickupPoolSubsystem.h"
+#include "Item.h"
+#include "Shooter.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pickup pool hits"), STAT_PickupPoolHits, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pickup pool misses"), STAT_PickupPoolMisses, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled pickups"), STAT_PooledPickups, STATGROUP_Shooter);
+
+void UPickupPoolSubsystem::Deinitialize()
+{
+	// The parked actors are torn down with the world
+	for (auto& PoolPair : Pools)
+	{
+		DEC_DWORD_STAT_BY(STAT_PooledPickups, PoolPair.Value.FreeItems.Num());
+	}
+	Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+AItem* UPickupPoolSubsystem::SpawnPooledItem(const UObject* WorldContextObject, TSubclassOf<AItem> ItemClass, const FTransform& SpawnTransform)
+{
+	if (ItemClass == nullptr) return nullptr;
+
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	if (World == nullptr) return nullptr;
+
+	if (World->IsGameWorld())
+	{
+		if (UPickupPoolSubsystem* PickupPool = World->GetSubsystem<UPickupPoolSubsystem>())
+		{
+			return PickupPool->AcquireItem(ItemClass, SpawnTransform);
+		}
+	}
+	return World->SpawnActor<AItem>(ItemClass, SpawnTransform);
+}
+
+void UPickupPoolSubsystem::DespawnPooledItem(AItem* Item)
+{
+	if (Item == nullptr) return;
+
+	UWorld* World = Item->GetWorld();
+	if (World && World->IsGameWorld())
+	{
+		if (UPickupPoolSubsystem* PickupPool = World->GetSubsystem<UPickupPoolSubsystem>())
+		{
+			PickupPool->ReleaseItem(Item);
+			return;
+		}
+	}
+	Item->Destroy();
+}
+
+AItem* UPickupPoolSubsystem::AcquireItem(TSubclassOf<AItem> ItemClass, const FTransform& SpawnTransform)
+{
+	if (ItemClass == nullptr) return nullptr;
+
+	FPickupPool* Pool = Pools.Find(ItemClass);
+	while (Pool && Pool->FreeItems.Num() > 0)
+	{
+		AItem* Item = Pool->FreeItems.Pop(false);
+		DEC_DWORD_STAT(STAT_PooledPickups);
+
+		// Parked items can still be destroyed by a level unload
+		if (IsValid(Item))
+		{
+			Item->OnAcquiredFromPool(SpawnTransform);
+			++PoolHits;
+			INC_DWORD_STAT(STAT_PickupPoolHits);
+			return Item;
+		}
+	}
+
+	++PoolMisses;
+	INC_DWORD_STAT(STAT_PickupPoolMisses);
+	return SpawnItem(ItemClass, SpawnTransform);
+}
+
+void UPickupPoolSubsystem::ReleaseItem(AItem* Item)
+{
+	if (!IsValid(Item) || Item->IsInPool()) return;
+
+	Item->OnReleasedToPool();
+
+	FPickupPool* Pool = Pools.Find(Item->GetClass());
+	if (Pool == nullptr)
+	{
+		Pool = &Pools.Add(Item->GetClass());
+		Pool->FreeItems.Reserve(FMath::Max(DefaultPoolReserve, 1));
+	}
+	Pool->FreeItems.Add(Item);
+	INC_DWORD_STAT(STAT_PooledPickups);
+}
+
+void UPickupPoolSubsystem::PrewarmPool(TSubclassOf<AItem> ItemClass, int32 Count)
+{
+	if (ItemClass == nullptr) return;
+
+	FPickupPool& Pool = Pools.FindOrAdd(ItemClass);
+	Pool.FreeItems.Reserve(FMath::Max(Count, DefaultPoolReserve));
+	while (Pool.FreeItems.Num() < Count)
+	{
+		AItem* Item = SpawnItem(ItemClass, FTransform::Identity);
+		if (Item == nullptr) return;
+
+		ReleaseItem(Item);
+	}
+}
+
+AItem* UPickupPoolSubsystem::SpawnItem(TSubclassOf<AItem> ItemClass, const FTransform& SpawnTransform)
+{
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return GetWorld()->SpawnActor<AItem>(ItemClass, SpawnTransform, SpawnParameters);
+}
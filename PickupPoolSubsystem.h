@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PickupPoolSubsystem.generated.h"
+
+class AItem;
+
+/* Parked pickups of one item class*/
+USTRUCT()
+struct FPickupPool
+{
+	GENERATED_BODY()
+
+	/* Hidden items ready to be reused*/
+	UPROPERTY()
+	TArray<AItem*> FreeItems;
+};
+
+/**
+ * Recycles ammo and weapon pickups so picking one up doesn't destroy an actor
+ * and dropping one doesn't spawn a new one. Released items are hidden, lose their
+ * collision and leave the pickup index; acquired items come back as fresh pickups.
+ */
+UCLASS(Config = Game)
+class SHOOTER_API UPickupPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	/* Acquires through the world's pool, or spawns a new actor if there isn't one*/
+	static AItem* SpawnPooledItem(const UObject* WorldContextObject, TSubclassOf<AItem> ItemClass, const FTransform& SpawnTransform);
+
+	/* Releases to the world's pool, or destroys the item if there isn't one*/
+	static void DespawnPooledItem(AItem* Item);
+
+	/* Returns a pooled item of ItemClass at SpawnTransform as a pickup, spawning one if the pool is empty*/
+	AItem* AcquireItem(TSubclassOf<AItem> ItemClass, const FTransform& SpawnTransform);
+
+	template <typename T>
+	T* AcquireItem(TSubclassOf<T> ItemClass, const FTransform& SpawnTransform)
+	{
+		return Cast<T>(AcquireItem(TSubclassOf<AItem>(ItemClass.Get()), SpawnTransform));
+	}
+
+	/* Parks Item so it can be acquired again*/
+	void ReleaseItem(AItem* Item);
+
+	/* Makes sure at least Count free items of ItemClass are parked*/
+	UFUNCTION(BlueprintCallable, Category = "Pickup Pool")
+	void PrewarmPool(TSubclassOf<AItem> ItemClass, int32 Count);
+
+	UFUNCTION(BlueprintCallable, Category = "Pickup Pool")
+	FORCEINLINE int32 GetPoolHits() const { return PoolHits; }
+
+	UFUNCTION(BlueprintCallable, Category = "Pickup Pool")
+	FORCEINLINE int32 GetPoolMisses() const { return PoolMisses; }
+
+private:
+
+	AItem* SpawnItem(TSubclassOf<AItem> ItemClass, const FTransform& SpawnTransform);
+
+	UPROPERTY()
+	TMap<UClass*, FPickupPool> Pools;
+
+	/* Free list capacity reserved the first time a class is pooled*/
+	UPROPERTY(Config)
+	int32 DefaultPoolReserve = 64;
+
+	/* Acquires served from a parked item*/
+	int32 PoolHits = 0;
+
+	/* Acquires that had to spawn an actor*/
+	int32 PoolMisses = 0;
+};
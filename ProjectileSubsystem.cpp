@@ -0,0 +1,171 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ProjectileSubsystem.h"
+#include "ShooterCharacter.h"
+#include "Shooter.h"
+
+DECLARE_CYCLE_STAT(TEXT("Projectile integrate"), STAT_ProjectileIntegrate, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Rounds in flight"), STAT_RoundsInFlight, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectile hits"), STAT_ProjectileHits, STATGROUP_Shooter);
+
+void UProjectileSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	TraceDelegate.BindUObject(this, &UProjectileSubsystem::OnTraceCompleted);
+}
+
+void UProjectileSubsystem::Deinitialize()
+{
+	TraceDelegate.Unbind();
+	DEC_DWORD_STAT_BY(STAT_RoundsInFlight, RoundIds.Num());
+
+	RoundIds.Empty();
+	Positions.Empty();
+	PreviousPositions.Empty();
+	Velocities.Empty();
+	GravityZ.Empty();
+	Ages.Empty();
+	BulletDamages.Empty();
+	Shooters.Empty();
+	RoundIndices.Empty();
+	CompletedTraces.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UProjectileSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProjectileSubsystem, STATGROUP_Tickables);
+}
+
+bool UProjectileSubsystem::FireRound(AShooterCharacter* Shooter, AWeapon* Weapon, const FVector& Location, const FVector& Velocity)
+{
+	if (Weapon == nullptr || RoundIds.Num() >= MaxRounds) return false;
+
+	const uint32 RoundId{ NextRoundId++ };
+	RoundIndices.Add(RoundId, RoundIds.Num());
+
+	RoundIds.Add(RoundId);
+	Positions.Add(Location);
+	PreviousPositions.Add(Location);
+	Velocities.Add(Velocity);
+	GravityZ.Add(GetWorld()->GetGravityZ() * Weapon->GetGravityScale());
+	Ages.Add(0.f);
+	BulletDamages.Add(Weapon->GetBulletDamage());
+	Shooters.Add(Shooter);
+
+	INC_DWORD_STAT(STAT_RoundsInFlight);
+	return true;
+}
+
+void UProjectileSubsystem::RemoveRound(int32 Index)
+{
+	RoundIndices.Remove(RoundIds[Index]);
+
+	RoundIds.RemoveAtSwap(Index, 1, false);
+	Positions.RemoveAtSwap(Index, 1, false);
+	PreviousPositions.RemoveAtSwap(Index, 1, false);
+	Velocities.RemoveAtSwap(Index, 1, false);
+	GravityZ.RemoveAtSwap(Index, 1, false);
+	Ages.RemoveAtSwap(Index, 1, false);
+	BulletDamages.RemoveAtSwap(Index, 1, false);
+	Shooters.RemoveAtSwap(Index, 1, false);
+
+	if (RoundIds.IsValidIndex(Index))
+	{
+		RoundIndices[RoundIds[Index]] = Index;
+	}
+	DEC_DWORD_STAT(STAT_RoundsInFlight);
+}
+
+void UProjectileSubsystem::OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Data)
+{
+	if (Data.OutHits.Num() == 0 || !Data.OutHits[0].bBlockingHit) return;
+
+	CompletedTraces.Add({ Data.UserData, Data.OutHits[0] });
+}
+
+void UProjectileSubsystem::Tick(float DeltaTime)
+{
+	// Last frame's segments were traced before this tick; a round that hit stops there
+	ResolveTraces();
+
+	if (RoundIds.Num() == 0) return;
+
+	IntegrateRounds(DeltaTime);
+	TraceSegments();
+}
+
+void UProjectileSubsystem::ResolveTraces()
+{
+	for (const FProjectileTraceResult& Trace : CompletedTraces)
+	{
+		const int32* Index = RoundIndices.Find(Trace.RoundId);
+		if (Index == nullptr) continue;
+
+		// Damage was taken when the round was fired; the weapon may since have been dropped or pooled
+		AShooterCharacter* Shooter = Shooters[*Index].Get();
+		if (Shooter)
+		{
+			// The beam is drawn along the segment that hit, as a tracer
+			const FVector Direction{ Velocities[*Index].GetSafeNormal() };
+			const FTransform SegmentTransform{ Direction.Rotation(), PreviousPositions[*Index] };
+			Shooter->ApplyBulletHit(BulletDamages[*Index], SegmentTransform, Trace.HitResult);
+			INC_DWORD_STAT(STAT_ProjectileHits);
+		}
+		RemoveRound(*Index);
+	}
+	CompletedTraces.Reset();
+}
+
+void UProjectileSubsystem::IntegrateRounds(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileIntegrate);
+
+	const int32 NumRounds{ RoundIds.Num() };
+
+	// Straight passes over the arrays with no branches, so the compiler can vectorise them
+	FVector* RESTRICT Position = Positions.GetData();
+	FVector* RESTRICT PreviousPosition = PreviousPositions.GetData();
+	FVector* RESTRICT Velocity = Velocities.GetData();
+	const float* RESTRICT Gravity = GravityZ.GetData();
+	float* RESTRICT Age = Ages.GetData();
+	for (int32 i = 0; i < NumRounds; i++)
+	{
+		PreviousPosition[i] = Position[i];
+		Velocity[i].Z += Gravity[i] * DeltaTime;
+		Position[i] += Velocity[i] * DeltaTime;
+		Age[i] += DeltaTime;
+	}
+
+	for (int32 i = NumRounds - 1; i >= 0; i--)
+	{
+		if (Ages[i] > RoundLifetime)
+		{
+			RemoveRound(i);
+		}
+	}
+}
+
+void UProjectileSubsystem::TraceSegments()
+{
+	UWorld* World = GetWorld();
+	const int32 NumRounds{ RoundIds.Num() };
+	for (int32 i = 0; i < NumRounds; i++)
+	{
+		// Rounds leave the barrel inside the shooter's capsule
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ProjectileSegment));
+		QueryParams.AddIgnoredActor(Shooters[i].Get());
+
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Single,
+			PreviousPositions[i],
+			Positions[i],
+			ECollisionChannel::ECC_Visibility,
+			QueryParams,
+			FCollisionResponseParams::DefaultResponseParam,
+			&TraceDelegate,
+			RoundIds[i]);
+	}
+}
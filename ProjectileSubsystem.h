@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "Weapon.h"
+#include "ProjectileSubsystem.generated.h"
+
+class AShooterCharacter;
+class AWeapon;
+
+/* A segment trace that came back since the last tick*/
+struct FProjectileTraceResult
+{
+	uint32 RoundId;
+
+	FHitResult HitResult;
+};
+
+/**
+ * Flies the rounds of ballistic weapons without an actor per bullet.
+ * Rounds are kept as parallel arrays and all integrated in one pass per frame; the
+ * segment each round covered is then traced through the async trace API, and a
+ * blocking hit goes through AShooterCharacter::ApplyBulletHit like a hitscan shot.
+ */
+UCLASS(Config = Game)
+class SHOOTER_API UProjectileSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/* Launches a round of Weapon from Location. False when MaxRounds are already in flight*/
+	bool FireRound(AShooterCharacter* Shooter, AWeapon* Weapon, const FVector& Location, const FVector& Velocity);
+
+	UFUNCTION(BlueprintCallable, Category = "Projectiles")
+	FORCEINLINE int32 GetNumRounds() const { return RoundIds.Num(); }
+
+private:
+
+	/* Called by the world when an async trace finishes*/
+	void OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Data);
+
+	/* Applies the hits that came back and drops their rounds*/
+	void ResolveTraces();
+
+	/* Moves every round one step and drops the ones past RoundLifetime*/
+	void IntegrateRounds(float DeltaTime);
+
+	/* One async trace along each round's segment this frame*/
+	void TraceSegments();
+
+	void RemoveRound(int32 Index);
+
+	/* Per round, all indexed together*/
+	TArray<uint32> RoundIds;
+	TArray<FVector> Positions;
+	TArray<FVector> PreviousPositions;
+	TArray<FVector> Velocities;
+	TArray<float> GravityZ;
+	TArray<float> Ages;
+	TArray<FBulletDamage> BulletDamages;
+	TArray<TWeakObjectPtr<AShooterCharacter>> Shooters;
+
+	/* Index into the arrays by round id*/
+	TMap<uint32, int32> RoundIndices;
+
+	TArray<FProjectileTraceResult> CompletedTraces;
+
+	uint32 NextRoundId = 0;
+
+	FTraceDelegate TraceDelegate;
+
+	/* Seconds a round flies before it is dropped*/
+	UPROPERTY(Config)
+	float RoundLifetime = 3.f;
+
+	/* Rounds in flight at once; more are refused*/
+	UPROPERTY(Config)
+	int32 MaxRounds = 2048;
+};
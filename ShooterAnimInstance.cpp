@@ -35,95 +35,124 @@ UShooterAnimInstance::UShooterAnimInstance() :
 {
 
 }
+const FName UShooterAnimInstance::TurningCurveName(TEXT("Turning"));
+const FName UShooterAnimInstance::RotationCurveName(TEXT("Rotation"));
+
 void UShooterAnimInstance::UpdateAnimationProperties(float DeltaTime)
 {
+    // Everything happens in NativeUpdateAnimation and NativeThreadSafeUpdateAnimation
+}
+
+void UShooterAnimInstance::NativeInitializeAnimation()
+{
+    Super::NativeInitializeAnimation();
+
+    ShooterCharacter = Cast<AShooterCharacter>(TryGetPawnOwner());
+}
+
+void UShooterAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
+{
+    Super::NativeUpdateAnimation(DeltaSeconds);
+
     if (ShooterCharacter == nullptr)
-        {
-            ShooterCharacter = Cast<AShooterCharacter>(TryGetPawnOwner());
-        }
+    {
+        ShooterCharacter = Cast<AShooterCharacter>(TryGetPawnOwner());
+    }
 
-    if (ShooterCharacter)
+    Snapshot.bValid = ShooterCharacter != nullptr;
+    if (!Snapshot.bValid) return;
+
+    // Only copies here; the math runs on a worker thread
+    const UCharacterMovementComponent* Movement = ShooterCharacter->GetCharacterMovement();
+    Snapshot.Velocity = ShooterCharacter->GetVelocity();
+    Snapshot.bAccelerating = Movement->GetCurrentAcceleration().SizeSquared() > 0.f;
+    Snapshot.bFalling = Movement->IsFalling();
+    Snapshot.AimRotation = ShooterCharacter->GetBaseAimRotation();
+    Snapshot.ActorRotation = ShooterCharacter->GetActorRotation();
+    Snapshot.CombatState = ShooterCharacter->GetCombatState();
+    Snapshot.bCrouching = ShooterCharacter->GetCrouching();
+    Snapshot.bAiming = ShooterCharacter->GetAiming();
+
+    // Keep the last weapon type when nothing is equipped, as before
+    if (ShooterCharacter->GetEquippedWeapon())
     {
-        bCrouching = ShooterCharacter->GetCrouching();
-        bReloading = ShooterCharacter->GetCombatState() == ECombatState::ECS_Reloading;
-        bEquipping = ShooterCharacter->GetCombatState() == ECombatState::ECS_Equipping;
-        bShouldUseFabrik = ShooterCharacter->GetCombatState() == ECombatState::ECS_Unoccupied 
-            || ShooterCharacter->GetCombatState() == ECombatState::ECS_FireTimerInProgress;
-
-        // Get the lateral speed of the character from velocity
-        FVector Velocity { ShooterCharacter->GetVelocity() };
-        Velocity.Z = 0;
-        Speed = Velocity.Size();
-
-        //Is the character in the air
-        bIsInAir = ShooterCharacter->GetCharacterMovement()->IsFalling();
-
-        //Is the character accelerating
-        if (ShooterCharacter->GetCharacterMovement()->GetCurrentAcceleration().Size() > 0.f)
-        {
-            bIsAccelerating = true;
-        }
-        else 
-        {
-            bIsAccelerating = false;
-        }
+        Snapshot.EquippedWeaponType = ShooterCharacter->GetEquippedWeapon()->GetWeaponType();
+    }
 
-        FRotator AimRotation = ShooterCharacter->GetBaseAimRotation();
-        FRotator MovementRotation = UKismetMathLibrary::MakeRotFromX(ShooterCharacter->GetVelocity());
-        
-        MovementOffsetYaw = UKismetMathLibrary::NormalizedDeltaRotator(MovementRotation, AimRotation).Yaw;
+    Snapshot.TurningCurve = GetCurveValue(TurningCurveName);
+    Snapshot.RotationCurve = GetCurveValue(RotationCurveName);
+}
 
-        if (ShooterCharacter->GetVelocity().Size() > 0.f)
-        {
-             LastMovementOffsetYaw = MovementOffsetYaw;
-        }
+void UShooterAnimInstance::NativeThreadSafeUpdateAnimation(float DeltaSeconds)
+{
+    Super::NativeThreadSafeUpdateAnimation(DeltaSeconds);
 
-        bAiming = ShooterCharacter->GetAiming();
+    if (!Snapshot.bValid) return;
 
-        if (bReloading)
-        {
-            OffsetState = EOffsetState::EOS_Reloading;
-        }
-        else if (bIsInAir)
-        {
-            OffsetState = EOffsetState::EOS_InAir;
-        }
-        else if (ShooterCharacter->GetAiming())
-        {
-            OffsetState = EOffsetState::EOS_Aiming;
-        }
-        else
-        {
-            OffsetState = EOffsetState::EOS_Hip;
-        }
-        //Check is shooter character has a valid equippedweapon
-        if (ShooterCharacter->GetEquippedWeapon())
-        {
-            EquippedWeaponType = ShooterCharacter->GetEquippedWeapon()->GetWeaponType();
-        }
-    }    
+    UpdateMovementProperties();
     TurnInPlace();
-    Lean(DeltaTime);
+    UpdateRecoilWeight();
+    Lean(DeltaSeconds);
 }
 
-void UShooterAnimInstance::NativeInitializeAnimation()
+void UShooterAnimInstance::UpdateMovementProperties()
 {
-    ShooterCharacter = Cast<AShooterCharacter>(TryGetPawnOwner());
+    bCrouching = Snapshot.bCrouching;
+    bReloading = Snapshot.CombatState == ECombatState::ECS_Reloading;
+    bEquipping = Snapshot.CombatState == ECombatState::ECS_Equipping;
+    bShouldUseFabrik = Snapshot.CombatState == ECombatState::ECS_Unoccupied
+        || Snapshot.CombatState == ECombatState::ECS_FireTimerInProgress;
+
+    // Get the lateral speed of the character from velocity
+    FVector Velocity{ Snapshot.Velocity };
+    Velocity.Z = 0;
+    Speed = Velocity.Size();
 
-   
+    bIsInAir = Snapshot.bFalling;
+    bIsAccelerating = Snapshot.bAccelerating;
+
+    const FRotator MovementRotation{ UKismetMathLibrary::MakeRotFromX(Snapshot.Velocity) };
+    MovementOffsetYaw = UKismetMathLibrary::NormalizedDeltaRotator(MovementRotation, Snapshot.AimRotation).Yaw;
+
+    if (Snapshot.Velocity.SizeSquared() > 0.f)
+    {
+         LastMovementOffsetYaw = MovementOffsetYaw;
+    }
+
+    bAiming = Snapshot.bAiming;
+
+    if (bReloading)
+    {
+        OffsetState = EOffsetState::EOS_Reloading;
+    }
+    else if (bIsInAir)
+    {
+        OffsetState = EOffsetState::EOS_InAir;
+    }
+    else if (bAiming)
+    {
+        OffsetState = EOffsetState::EOS_Aiming;
+    }
+    else
+    {
+        OffsetState = EOffsetState::EOS_Hip;
+    }
+
+    if (Snapshot.EquippedWeaponType != EWeaponType::EWT_MAX)
+    {
+        EquippedWeaponType = Snapshot.EquippedWeaponType;
+    }
 }
 
 void UShooterAnimInstance::TurnInPlace()
 {
-    if (ShooterCharacter == nullptr) return;
-
-    Pitch = ShooterCharacter->GetBaseAimRotation().Pitch;
+    Pitch = Snapshot.AimRotation.Pitch;
         
     if (Speed > 0 || bIsInAir)
     {
         // Don't want to turn in place; character is moving
         RootYawOffset = 0.f;
-        TIPCharacterYaw = ShooterCharacter->GetActorRotation().Yaw;
+        TIPCharacterYaw = Snapshot.ActorRotation.Yaw;
         TIPCharacterYawLastFrame = TIPCharacterYaw;
         RotationCurveLastFrame = 0.f;
         RotationCurve = 0.f;
@@ -131,20 +160,20 @@ void UShooterAnimInstance::TurnInPlace()
     else
     {
         TIPCharacterYawLastFrame = TIPCharacterYaw;
-        TIPCharacterYaw = ShooterCharacter->GetActorRotation().Yaw;
+        TIPCharacterYaw = Snapshot.ActorRotation.Yaw;
         const float TIPYawDelta{ TIPCharacterYaw - TIPCharacterYawLastFrame };
 
         // Root yaw offset updated and clamped to [-180, 180]
         RootYawOffset = UKismetMathLibrary::NormalizeAxis(RootYawOffset - TIPYawDelta);
 
-        const float Turning{ GetCurveValue(TEXT("Turning")) };
+        const float Turning{ Snapshot.TurningCurve };
 
         /* 1.0 if turning. 0.0 if not*/
         if (Turning > 0)
         {
             bTurningInPlace = true;
             RotationCurveLastFrame = RotationCurve;
-            RotationCurve = GetCurveValue(TEXT("Rotation"));
+            RotationCurve = Snapshot.RotationCurve;
             const float DeltaRotation{ RotationCurve - RotationCurveLastFrame };
 
 
@@ -164,7 +193,10 @@ void UShooterAnimInstance::TurnInPlace()
             bTurningInPlace = false;
         }
     }
-    /* Set the recoil weight*/
+}
+
+void UShooterAnimInstance::UpdateRecoilWeight()
+{
     if (bTurningInPlace)
     {
         if (bReloading || bEquipping)
@@ -206,10 +238,8 @@ void UShooterAnimInstance::TurnInPlace()
 
 void UShooterAnimInstance::Lean(float DeltaTime)
 {
-    if (ShooterCharacter == nullptr) return;
-
     CharacterRotationLastFrame = CharacterRotation;
-    CharacterRotation = ShooterCharacter->GetActorRotation();
+    CharacterRotation = Snapshot.ActorRotation;
 
     const FRotator Delta{ UKismetMathLibrary::NormalizedDeltaRotator(CharacterRotation, CharacterRotationLastFrame) };
 
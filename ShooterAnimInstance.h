@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
 #include "WeaponType.h"
+#include "ShooterCharacter.h"
 #include "ShooterAnimInstance.generated.h"
 
 UENUM(BlueprintType)
@@ -18,6 +19,28 @@ enum class EOffsetState : uint8
 	EOS_MAX			UMETA(DisplayName = "Default Max")
 };
 
+/* Everything the animation update needs from the character, copied on the game thread*/
+struct FShooterAnimSnapshot
+{
+	bool bValid = false;
+
+	FVector Velocity = FVector::ZeroVector;
+	bool bAccelerating = false;
+	bool bFalling = false;
+	FRotator AimRotation = FRotator::ZeroRotator;
+	FRotator ActorRotation = FRotator::ZeroRotator;
+	ECombatState CombatState = ECombatState::ECS_Unoccupied;
+	bool bCrouching = false;
+	bool bAiming = false;
+
+	/* EWT_MAX when nothing is equipped*/
+	EWeaponType EquippedWeaponType = EWeaponType::EWT_MAX;
+
+	/* Turn in place curves from the last evaluated pose*/
+	float TurningCurve = 0.f;
+	float RotationCurve = 0.f;
+};
+
 /**
  * 
  */
@@ -28,18 +51,31 @@ class SHOOTER_API UShooterAnimInstance : public UAnimInstance
 
 public: 
 
-	UFUNCTION(BlueprintCallable)
+	/* The update runs natively now; the event graph call can be removed*/
+	UFUNCTION(BlueprintCallable, meta = (DeprecatedFunction, DeprecationMessage = "Runs from NativeUpdateAnimation and NativeThreadSafeUpdateAnimation"))
 	void UpdateAnimationProperties(float DeltaTime);
 
 	virtual void NativeInitializeAnimation() override;	
 
+	/* Game thread: copies what the update needs into Snapshot*/
+	virtual void NativeUpdateAnimation(float DeltaSeconds) override;
+
+	/* Worker thread: works out every property from Snapshot*/
+	virtual void NativeThreadSafeUpdateAnimation(float DeltaSeconds) override;
+
 	UShooterAnimInstance();
 
 protected:
 
+	/* Movement, aiming, combat and offset state from the snapshot*/
+	void UpdateMovementProperties();
+
 	/* Handle turning in place variables*/
 	void TurnInPlace();
 
+	/* Recoil weight from turn in place, crouching, aiming and combat state*/
+	void UpdateRecoilWeight();
+
 	/* handle calculations for leaning while running*/
 	void Lean(float DeltaTime);
 
@@ -129,4 +165,11 @@ private:
 	/* True when not reloading or equipping*/
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
 	bool bShouldUseFabrik;
+
+	/* Filled on the game thread, read on the worker thread*/
+	FShooterAnimSnapshot Snapshot;
+
+	/* Turn in place curve names, made once instead of on every lookup*/
+	static const FName TurningCurveName;
+	static const FName RotationCurveName;
 };
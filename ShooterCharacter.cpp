@@ -22,6 +22,20 @@
 #include "Shooter.h"
 #include "BulletHitInterface.h"
 #include "Enemy.h"
+#include "HitscanSubsystem.h"
+#include "HitAggregationSubsystem.h"
+#include "ProjectileSubsystem.h"
+#include "EmitterPoolSubsystem.h"
+#include "FireScheduler.h"
+#include "PickupIndexSubsystem.h"
+#include "PickupPoolSubsystem.h"
+#include "PickupInstanceSubsystem.h"
+#include "ItemPickupWidget.h"
+#include "ShooterDataRegistry.h"
+#include "WeaponAssetStreamer.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crosshair traces saved"), STAT_CrosshairTracesSaved, STATGROUP_Shooter);
+DECLARE_MEMORY_STAT(TEXT("Dehydrated inventory savings"), STAT_DehydratedInventoryBytes, STATGROUP_Shooter);
 
 // Sets default values
 AShooterCharacter::AShooterCharacter() :
@@ -59,6 +73,11 @@ AShooterCharacter::AShooterCharacter() :
 	CrosshairAimFactor(0.f),
 	CrosshairShootingFactor(0.f),
 
+	// Async hitscan by default; the blocking traces are the fallback
+	bAsyncHitscan(true),
+	EmitterPoolPrewarmCount(16),
+	MaxShotsPerFrame(8),
+
 	// Bullet timer fire variables
 	ShootTimeDuration(0.05),
 	bFiringBullet(false),
@@ -66,11 +85,15 @@ AShooterCharacter::AShooterCharacter() :
 	// Auto gunfire variables
 	bFireButtonPressed(false),
 	bShouldFire(true),
-	
+	LastFireCrosshairStart(FVector::ZeroVector),
+	LastFireCrosshairEnd(FVector::ZeroVector),
+
 
 	//Item trace variables
-	bShouldTraceForItems(false),
-	OverlappedItemCount(0),
+	PickupViewConeAngle(20.f),
+	PickupWidgetOffset(0.f, 0.f, 75.f),
+	PickupWidgetItem(nullptr),
+	CrosshairTracesSaved(0),
 
 	//Camera interp location variables
 	CameraInterpDistance(250.f),
@@ -95,12 +118,16 @@ AShooterCharacter::AShooterCharacter() :
 	CrouchingGroundFriction(100.f),
 
 	bAimingButtonPressed(false),
+	NextInterpLocIndex(1),
 
 	// Pickip sound timer properties
 	bShouldPlayPickupSound(true),
 	bShouldPlayEquipSound(true),
 	PickupSoundResetTime(0.2f),
 	EquipSoundResetTime(0.2f),
+	DehydratedBytesSaved(0),
+	InventoryCapacity(6),
+	FreeSlotMask(0),
 
 	// Icon Animation Property
 	HighlightedSlot(-1)
@@ -133,6 +160,9 @@ AShooterCharacter::AShooterCharacter() :
 	GetCharacterMovement()->JumpZVelocity = 500.f;
 	GetCharacterMovement()->AirControl = 0.2f;
 
+	/** Slot hotkeys; F selects the first slot*/
+	InventorySlotActions = { FName("FKey"), FName("OneKey"), FName("TwoKey"), FName("ThreeKey"), FName("FourKey"), FName("FiveKey") };
+
 	HandSceneComponent = CreateDefaultSubobject<USceneComponent>(TEXT("HandSceneComponent"));
 
 	/* Create interpolation components*/
@@ -157,6 +187,15 @@ AShooterCharacter::AShooterCharacter() :
 	InterpComp6 = CreateDefaultSubobject<USceneComponent>(TEXT("Interpolation Component 6"));
 	InterpComp6->SetupAttachment(GetFollowCamera());
 	//
+
+	/* Shared pickup popup; placed in world space over the focused item*/
+	PickupWidgetComponent = CreateDefaultSubobject<UWidgetComponent>(TEXT("PickupWidgetComponent"));
+	PickupWidgetComponent->SetupAttachment(GetRootComponent());
+	PickupWidgetComponent->SetUsingAbsoluteLocation(true);
+	PickupWidgetComponent->SetWidgetSpace(EWidgetSpace::Screen);
+	PickupWidgetComponent->SetDrawAtDesiredSize(true);
+	PickupWidgetComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	PickupWidgetComponent->SetVisibility(false);
 }
 
 // Called when the game starts or when spawned
@@ -170,10 +209,16 @@ void AShooterCharacter::BeginPlay()
 		CameraCurrentFOV = CameraDefaultFOV;
 	}
 
+	// Every slot exists up front; FreeSlotMask tracks which are in use
+	InventoryCapacity = FMath::Clamp(InventoryCapacity, 1, 64);
+	Inventory.SetNum(InventoryCapacity);
+	ItemStacks.SetNum(InventoryCapacity);
+	FreeSlotMask = InventoryCapacity == 64 ? MAX_uint64 : (uint64(1) << InventoryCapacity) - 1;
+
 	/** Spawn the default weapon and attach it to the mesh and equip it*/
 	EquipWeapon(SpawnDefaultWeapon());
-	Inventory.Add(EquippedWeapon);
-	EquippedWeapon->SetSlotIndex(0);
+	EquippedWeapon->SetSlotIndex(AllocateInventorySlot());
+	Inventory[EquippedWeapon->GetSlotIndex()] = EquippedWeapon->MakeRecord();
 	EquippedWeapon->DisableCustomDepth();
 	EquippedWeapon->DisableGlowMaterial();
 	EquippedWeapon->SetCharacter(this);
@@ -184,6 +229,57 @@ void AShooterCharacter::BeginPlay()
 
 	/* Create FInterpLocation structs for each interp location. Add to array*/
 	InitializeInterpLocations();
+
+	/* Warm up the emitter pools used every shot*/
+	PrewarmEmitterPools();
+
+	if (PickupWidgetClass)
+	{
+		PickupWidgetComponent->SetWidgetClass(PickupWidgetClass);
+	}
+}
+
+void AShooterCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UPickupIndexSubsystem* PickupIndex = GetWorld()->GetSubsystem<UPickupIndexSubsystem>())
+	{
+		PickupIndex->RemovePlayer(this);
+	}
+	if (UPickupInstanceSubsystem* PickupInstances = GetWorld()->GetSubsystem<UPickupInstanceSubsystem>())
+	{
+		PickupInstances->RemovePlayer(this);
+	}
+
+	// Records hold asset tiers in place of their actors
+	if (UWeaponAssetStreamer* AssetStreamer = UWeaponAssetStreamer::Get())
+	{
+		for (int32 i = 0; i < Inventory.Num(); i++)
+		{
+			if (Inventory[i].IsEmpty() || (EquippedWeapon && EquippedWeapon->GetSlotIndex() == i)) continue;
+
+			AssetStreamer->ReleaseAssets(Inventory[i].WeaponType, EWeaponAssetTier::EWAT_Pickup);
+			AssetStreamer->ReleaseAssets(Inventory[i].WeaponType, EWeaponAssetTier::EWAT_Equip);
+		}
+	}
+	DEC_MEMORY_STAT_BY(STAT_DehydratedInventoryBytes, DehydratedBytesSaved);
+	DehydratedBytesSaved = 0;
+	DehydratedClassBytes.Empty();
+	Inventory.Empty();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AShooterCharacter::PrewarmEmitterPools()
+{
+	UEmitterPoolSubsystem* EmitterPool = GetWorld()->GetSubsystem<UEmitterPoolSubsystem>();
+	if (EmitterPool == nullptr) return;
+
+	EmitterPool->PrewarmPool(ImpactParticles, EmitterPoolPrewarmCount);
+	EmitterPool->PrewarmPool(BeamParticles, EmitterPoolPrewarmCount);
+	if (EquippedWeapon)
+	{
+		EmitterPool->PrewarmPool(EquippedWeapon->GetMuzzleFlash(), EmitterPoolPrewarmCount);
+	}
 }
 
 void AShooterCharacter::MoveForward(float Value)
@@ -404,29 +500,74 @@ void AShooterCharacter::StartFireTimer()
 	if (EquippedWeapon == nullptr) return;
 	CombatState = ECombatState::ECS_FireTimerInProgress;
 
-	GetWorldTimerManager().SetTimer(AutoFireTimer, this, &AShooterCharacter::AutoFireReset, EquippedWeapon->GetAutoFireRate());
+	FireScheduler.Start(EquippedWeapon->GetAutoFireRate(), MaxShotsPerFrame);
+
+	// Shots fired before next tick interpolate from here
+	GetBarrelSocketTransform(LastFireSocketTransform);
+	GetCrosshairRay(LastFireCrosshairStart, LastFireCrosshairEnd);
 }
 
-void AShooterCharacter::AutoFireReset()
+void AShooterCharacter::UpdateAutoFire(float DeltaTime)
 {
+	if (!FireScheduler.IsActive()) return;
 
-	CombatState = ECombatState::ECS_Unoccupied;
-	if (EquippedWeapon == nullptr) return;
-	if (WeaponHasAmmo())
+	FireScheduler.Advance(DeltaTime, ScheduledShotAlphas);
+
+	FTransform SocketTransform;
+	FVector CrosshairStart;
+	FVector CrosshairEnd;
+	const bool bCanAim{ GetBarrelSocketTransform(SocketTransform) && GetCrosshairRay(CrosshairStart, CrosshairEnd) };
+
+	TArray<FHitscanShotRequest> ShotBatch;
+	for (const float ShotAlpha : ScheduledShotAlphas)
 	{
-		if (bFireButtonPressed && EquippedWeapon->GetAutomatic())
+		// The fire interval is up; the checks the auto fire timer used to make
+		CombatState = ECombatState::ECS_Unoccupied;
+		if (EquippedWeapon == nullptr || !bCanAim)
 		{
-			FireWeapon();
+			FireScheduler.Stop();
+			break;
 		}
+		if (!WeaponHasAmmo())
+		{
+			FireScheduler.Stop();
+			ReloadWeapon();
+			break;
+		}
+		if (!bFireButtonPressed || !EquippedWeapon->GetAutomatic())
+		{
+			FireScheduler.Stop();
+			break;
+		}
+
+		// Where the barrel and crosshair were when this shot was due
+		FHitscanShotRequest& Shot = ShotBatch.AddDefaulted_GetRef();
+		Shot.SocketTransform.Blend(LastFireSocketTransform, SocketTransform, ShotAlpha);
+		Shot.CrosshairStart = FMath::Lerp(LastFireCrosshairStart, CrosshairStart, ShotAlpha);
+		Shot.CrosshairEnd = FMath::Lerp(LastFireCrosshairEnd, CrosshairEnd, ShotAlpha);
+
+		if (EquippedWeapon->GetMuzzleFlash())
+		{
+			UEmitterPoolSubsystem::SpawnPooledEmitter(this, EquippedWeapon->GetMuzzleFlash(), Shot.SocketTransform);
+		}
+		ConsumeShot();
+		CombatState = ECombatState::ECS_FireTimerInProgress;
 	}
-	else
+
+	if (ShotBatch.Num() > 0)
 	{
-		ReloadWeapon();
+		SendBulletBatch(ShotBatch);
+	}
+
+	if (bCanAim)
+	{
+		LastFireSocketTransform = SocketTransform;
+		LastFireCrosshairStart = CrosshairStart;
+		LastFireCrosshairEnd = CrosshairEnd;
 	}
-	
 }
 
-bool AShooterCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation)
+bool AShooterCharacter::GetCrosshairRay(FVector& OutStart, FVector& OutEnd)
 {
 	// Get viewport size
 	FVector2D ViewportSize;
@@ -449,18 +590,64 @@ bool AShooterCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult, FVector&
 	if (bScreenToWorld)
 	{
 		// Trace from crosshair world location outward
-		const FVector Start{CrosshairWorldPosition};
-		const FVector End {Start + CrosshairWorldDirection * 50'000.f};
-		OutHitLocation = End;
-		GetWorld()->LineTraceSingleByChannel(OutHitResult, Start, End, ECollisionChannel::ECC_Visibility);
+		OutStart = CrosshairWorldPosition;
+		OutEnd = OutStart + CrosshairWorldDirection * 50'000.f;
+	}
+	return bScreenToWorld;
+}
+
+bool AShooterCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation)
+{
+	const FCrosshairTraceResult& CrosshairTrace = GetCrosshairTrace();
+	OutHitResult = CrosshairTrace.HitResult;
+	OutHitLocation = CrosshairTrace.HitLocation;
+	return CrosshairTrace.bHit;
+}
+
+bool AShooterCharacter::IsCrosshairTraceFresh() const
+{
+	return CrosshairTraceCache.FrameNumber == GFrameCounter &&
+		CrosshairTraceCache.CameraTransform.Equals(FollowCamera->GetComponentTransform());
+}
 
-		if (OutHitResult.bBlockingHit)
+const FCrosshairTraceResult& AShooterCharacter::GetCrosshairTrace()
+{
+	if (IsCrosshairTraceFresh())
+	{
+		// Already traced this ray this frame
+		++CrosshairTracesSaved;
+		INC_DWORD_STAT(STAT_CrosshairTracesSaved);
+		return CrosshairTraceCache;
+	}
+
+	if (CrosshairTraceCache.FrameNumber != GFrameCounter)
+	{
+		CrosshairTracesSaved = 0;
+	}
+	CrosshairTraceCache.FrameNumber = GFrameCounter;
+	CrosshairTraceCache.CameraTransform = FollowCamera->GetComponentTransform();
+	CrosshairTraceCache.HitResult = FHitResult();
+	CrosshairTraceCache.bHit = false;
+
+	FVector Start;
+	FVector End;
+	if (GetCrosshairRay(Start, End))
+	{
+		CrosshairTraceCache.HitLocation = End;
+		GetWorld()->LineTraceSingleByChannel(CrosshairTraceCache.HitResult, Start, End, ECollisionChannel::ECC_Visibility);
+
+		if (CrosshairTraceCache.HitResult.bBlockingHit)
 		{
-			OutHitLocation = OutHitResult.Location;
-			return true;
+			CrosshairTraceCache.HitLocation = CrosshairTraceCache.HitResult.Location;
+			CrosshairTraceCache.bHit = true;
 		}
-	}		
-	return false;
+	}
+	return CrosshairTraceCache;
+}
+
+int32 AShooterCharacter::GetCrosshairTracesSavedThisFrame() const
+{
+	return CrosshairTraceCache.FrameNumber == GFrameCounter ? CrosshairTracesSaved : 0;
 }
 
 // Called every frame
@@ -477,11 +664,17 @@ void AShooterCharacter::Tick(float DeltaTime)
 	// Calculate crosshair spread multiplier
 	CalculateCrosshairSpread(DeltaTime);
 
-	// Checked overlapped item count and then trace for items
+	// Focus the pickup in view, if any are in range
 	TraceForItems();
 
 	// Interpolate the capsule half height based on crouching/standing
 	InterpCapsuleHalfHeight(DeltaTime);
+
+	// Fire any automatic shots due this frame
+	UpdateAutoFire(DeltaTime);
+
+	// Fly picked up items toward the camera
+	UpdateItemInterps(DeltaTime);
 	
 }
 
@@ -494,19 +687,24 @@ void AShooterCharacter::FireWeapon()
 
 	if (WeaponHasAmmo())
 	{
-		PlayFireSound();
 		SendBullet();
-		PlayGunfireMontage();
-		EquippedWeapon->DecrementAmmo();
-		StartCrosshairBulletFire();
+		ConsumeShot();
 
 		StartFireTimer();
+	}
+}
 
-		if (EquippedWeapon->GetWeaponType() == EWeaponType::EWT_Pistol)
-		{
-			// Start moving slide timer
-			EquippedWeapon->StartSlideTimer();
-		}
+void AShooterCharacter::ConsumeShot()
+{
+	PlayFireSound();
+	PlayGunfireMontage();
+	EquippedWeapon->DecrementAmmo();
+	StartCrosshairBulletFire();
+
+	if (EquippedWeapon->GetWeaponType() == EWeaponType::EWT_Pistol)
+	{
+		// Start moving slide timer
+		EquippedWeapon->StartSlideTimer();
 	}
 }
 
@@ -546,12 +744,10 @@ void AShooterCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCo
 	* Gun Inventory bindings
 	*
 	*/
-	PlayerInputComponent->BindAction("FKey", IE_Pressed, this, &AShooterCharacter::FKeyPressed);
-	PlayerInputComponent->BindAction("OneKey", IE_Pressed, this, &AShooterCharacter::OneKeyPressed);
-	PlayerInputComponent->BindAction("TwoKey", IE_Pressed, this, &AShooterCharacter::TwoKeyPressed);
-	PlayerInputComponent->BindAction("ThreeKey", IE_Pressed, this, &AShooterCharacter::ThreeKeyPressed);
-	PlayerInputComponent->BindAction("FourKey", IE_Pressed, this, &AShooterCharacter::FourKeyPressed);
-	PlayerInputComponent->BindAction("FiveKey", IE_Pressed, this, &AShooterCharacter::FiveKeyPressed);
+	for (int32 i = 0; i < InventorySlotActions.Num(); i++)
+	{
+		PlayerInputComponent->BindAction<FInventorySlotInputDelegate>(InventorySlotActions[i], IE_Pressed, this, &AShooterCharacter::InventorySlotPressed, i);
+	}
 
 }
 
@@ -560,103 +756,111 @@ float AShooterCharacter::GetCrosshairSpreadMulitplier() const
 	return CrosshairSpreadMultiplier;
 }
 
-void AShooterCharacter::IncrementOverlappedItemCount(int8 Amount)
+void AShooterCharacter::TraceForItems()
 {
-	if (OverlappedItemCount + Amount <= 0)
+	UPickupIndexSubsystem* PickupIndex = GetWorld()->GetSubsystem<UPickupIndexSubsystem>();
+	if (PickupIndex == nullptr) return;
+
+	// Instanced pickups in range become actors first so the index sees them this frame
+	if (UPickupInstanceSubsystem* PickupInstances = GetWorld()->GetSubsystem<UPickupInstanceSubsystem>())
 	{
-		OverlappedItemCount = 0;
-		bShouldTraceForItems = false;
+		PickupInstances->UpdatePlayerPromotion(this, GetActorLocation());
 	}
-	else
+
+	// Pickups in range prefetch their assets
+	PickupIndex->UpdatePlayerProximity(this, GetActorLocation());
+
+	FVector CrosshairStart;
+	FVector CrosshairEnd;
+	TraceHitItem = nullptr;
+	if (GetCrosshairRay(CrosshairStart, CrosshairEnd))
 	{
-		OverlappedItemCount += Amount;
-		bShouldTraceForItems = true;
+		const FVector ViewDirection{ (CrosshairEnd - CrosshairStart).GetSafeNormal() };
+		TraceHitItem = PickupIndex->FindBestPickup(GetActorLocation(), CrosshairStart, ViewDirection,
+			FMath::Cos(FMath::DegreesToRadians(PickupViewConeAngle)));
 	}
-}
 
-void AShooterCharacter::TraceForItems()
-{
-	if (bShouldTraceForItems)
+	const auto TraceHitWeapon = Cast<AWeapon>(TraceHitItem);
+	if (TraceHitWeapon)
 	{
-		FHitResult ItemTraceResult;
-		FVector HitLocation;
-		TraceUnderCrosshairs(ItemTraceResult, HitLocation);
-		if (ItemTraceResult.bBlockingHit)
+		if (HighlightedSlot == -1)
 		{
-			TraceHitItem = Cast<AItem>(ItemTraceResult.GetActor());
-			const auto TraceHitWeapon = Cast<AWeapon>(TraceHitItem);
-			if (TraceHitWeapon)
-			{
-				if (HighlightedSlot == -1)
-				{
-					//Not currently highlighting a slot--highlight one
-					HighlightInventorySlot();
-				}
-			}
-			else
-			{
-				// Is a slot being highlighted
-				if (HighlightedSlot != -1)
-				{
-					// Unhighlight the slot
-					UnhighlightInventorySlot();
-				}
-			}
+			//Not currently highlighting a slot--highlight one
+			HighlightInventorySlot();
+		}
+	}
+	else
+	{
+		// Is a slot being highlighted
+		if (HighlightedSlot != -1)
+		{
+			// Unhighlight the slot
+			UnhighlightInventorySlot();
+		}
+	}
 
-			if (TraceHitItem && TraceHitItem->GetItemState() == EItemState::EIS_EquipInterping)
-			{
-				TraceHitItem = nullptr;
-			}
+	if (TraceHitItem)
+	{
+		TraceHitItem->EnableCustomDepth();
 
-			if (TraceHitItem && TraceHitItem->GetPickupWidget())
-			{
-				//Show item's pickup widget
-				TraceHitItem->GetPickupWidget()->SetVisibility(true);
-				TraceHitItem->EnableCustomDepth();
-
-				if (Inventory.Num() >= INVENTORY_CAPACITY)
-				{
-					// Inventory is full
-					TraceHitItem->SetCharacterInventoryFull(true);
-				}
-				else
-				{
-					// Inventory has room
-					TraceHitItem->SetCharacterInventoryFull(false);
-				}
-			}
-			//We hit an AItem last frame
-			if (TraceHitItemLastFrame)
-			{
-				if (TraceHitItem != TraceHitItemLastFrame)
-				{
-					//We are hitting a different AItem this round this frame
-					// or AItem is null
-					TraceHitItemLastFrame->GetPickupWidget()->SetVisibility(false);
-					TraceHitItemLastFrame->DisableCustomDepth();
-				}
-			}
-			// Store a referenece to HitItem for next frame
-			TraceHitItemLastFrame = TraceHitItem;
+		TraceHitItem->SetCharacterInventoryFull(!HasInventoryRoomFor(TraceHitItem));
+	}
+
+	// Retarget the popup when focus moves, including when the focused item was picked up
+	if (TraceHitItem != PickupWidgetItem)
+	{
+		ShowPickupWidget(TraceHitItem);
+	}
+	else if (TraceHitItem)
+	{
+		// Same item; only the inventory full warning can change
+		UItemPickupWidget* PickupWidget = Cast<UItemPickupWidget>(PickupWidgetComponent->GetWidget());
+		if (PickupWidget)
+		{
+			PickupWidget->SetCharacterInventoryFull(TraceHitItem->IsCharacterInventoryFull());
 		}
 	}
-	else if (TraceHitItemLastFrame)
+
+	//We focused an AItem last frame
+	if (TraceHitItemLastFrame)
 	{
-		// No longer overlapping any items,
-		// Item last frame should not show widget
-		TraceHitItemLastFrame->GetPickupWidget()->SetVisibility(false);
-		TraceHitItemLastFrame->DisableCustomDepth();
+		if (TraceHitItem != TraceHitItemLastFrame)
+		{
+			//We are focusing a different AItem this frame
+			// or AItem is null
+			TraceHitItemLastFrame->DisableCustomDepth();
+		}
 	}
+	// Store a referenece to HitItem for next frame
+	TraceHitItemLastFrame = TraceHitItem;
 }
 
 
+void AShooterCharacter::ShowPickupWidget(AItem* Item)
+{
+	PickupWidgetItem = Item;
+	if (Item == nullptr || !IsLocallyControlled())
+	{
+		PickupWidgetComponent->SetVisibility(false);
+		return;
+	}
+
+	// Pickups don't move while they can be focused, so placing it once is enough
+	PickupWidgetComponent->SetWorldLocation(Item->GetActorLocation() + PickupWidgetOffset);
+	if (UItemPickupWidget* PickupWidget = Cast<UItemPickupWidget>(PickupWidgetComponent->GetWidget()))
+	{
+		PickupWidget->SetItem(Item);
+	}
+	PickupWidgetComponent->SetVisibility(true);
+}
+
 AWeapon* AShooterCharacter::SpawnDefaultWeapon()
 {
 	//Check the TSubclassOf variable
 	if (DefaultWeaponClass)
 	{
-		// spawn weapon
-		return GetWorld()->SpawnActor<AWeapon>(DefaultWeaponClass);
+		// spawn weapon, reusing a parked one when there is one
+		return Cast<AWeapon>(UPickupPoolSubsystem::SpawnPooledItem(this, DefaultWeaponClass, FTransform::Identity));
 		
 	}
 	return nullptr;
@@ -710,6 +914,10 @@ void AShooterCharacter::SelectButtonPressed()
 	if (CombatState != ECombatState::ECS_Unoccupied) return;
 	if (TraceHitItem)
 	{
+		// Weapons swap with the equipped one and ammo takes no slot; anything else needs room
+		const bool bNeedsRoom{ Cast<AWeapon>(TraceHitItem) == nullptr && Cast<AAmmo>(TraceHitItem) == nullptr };
+		if (bNeedsRoom && !HasInventoryRoomFor(TraceHitItem)) return;
+
 		TraceHitItem->StartItemCurve(this, true);
 		TraceHitItem = nullptr;
 	
@@ -724,10 +932,10 @@ void AShooterCharacter::SelectButtonReleased()
 
 void AShooterCharacter::SwapWeapon(AWeapon* WeaponToSwap)
 {
-	if (Inventory.Num() - 1 >= EquippedWeapon->GetSlotIndex())
+	if (Inventory.IsValidIndex(EquippedWeapon->GetSlotIndex()))
 	{
-		Inventory[EquippedWeapon->GetSlotIndex()] = WeaponToSwap;
 		WeaponToSwap->SetSlotIndex(EquippedWeapon->GetSlotIndex());
+		Inventory[EquippedWeapon->GetSlotIndex()] = WeaponToSwap->MakeRecord();
 	}
 
 	DropWeapon();
@@ -736,6 +944,78 @@ void AShooterCharacter::SwapWeapon(AWeapon* WeaponToSwap)
 	TraceHitItemLastFrame = nullptr;
 }
 
+FWeaponRecord AShooterCharacter::DehydrateWeapon(AWeapon* Weapon)
+{
+	const FWeaponRecord Record{ Weapon->MakeRecord() };
+
+	// Hold the asset tiers the actor held, so the icons stay resident and the weapon equips without a hitch
+	if (UWeaponAssetStreamer* AssetStreamer = UWeaponAssetStreamer::Get())
+	{
+		AssetStreamer->AcquireAssets(Record.WeaponType, EWeaponAssetTier::EWAT_Pickup, FStreamableDelegate());
+		AssetStreamer->AcquireAssets(Record.WeaponType, EWeaponAssetTier::EWAT_Equip, FStreamableDelegate());
+	}
+
+	const int64 Savings{ GetDehydratedWeaponSavings(Weapon) };
+	DehydratedBytesSaved += Savings;
+	INC_MEMORY_STAT_BY(STAT_DehydratedInventoryBytes, Savings);
+
+	// Destroyed rather than pooled; a parked actor would still take the memory the record saves
+	Weapon->Destroy();
+	return Record;
+}
+
+AWeapon* AShooterCharacter::HydrateWeapon(const FWeaponRecord& Record)
+{
+	AWeapon* Weapon = Cast<AWeapon>(UPickupPoolSubsystem::SpawnPooledItem(this, Record.WeaponClass, GetActorTransform()));
+	if (Weapon == nullptr) return nullptr;
+
+	Weapon->ApplyRecord(Record);
+	Weapon->SetCharacter(this);
+	Weapon->DisableCustomDepth();
+	Weapon->DisableGlowMaterial();
+	Weapon->SetItemState(EItemState::EIS_PickedUp);
+
+	// The actor now holds its own asset tiers
+	if (UWeaponAssetStreamer* AssetStreamer = UWeaponAssetStreamer::Get())
+	{
+		AssetStreamer->ReleaseAssets(Record.WeaponType, EWeaponAssetTier::EWAT_Pickup);
+		AssetStreamer->ReleaseAssets(Record.WeaponType, EWeaponAssetTier::EWAT_Equip);
+	}
+
+	const int64 Savings{ GetDehydratedWeaponSavings(Weapon) };
+	DehydratedBytesSaved -= Savings;
+	DEC_MEMORY_STAT_BY(STAT_DehydratedInventoryBytes, Savings);
+	return Weapon;
+}
+
+int64 AShooterCharacter::GetDehydratedWeaponSavings(const AWeapon* Weapon)
+{
+	// Sizes only depend on the class, so measure each class once
+	if (const int64* Bytes = DehydratedClassBytes.Find(Weapon->GetClass()))
+	{
+		return *Bytes;
+	}
+
+	int64 Bytes{ Weapon->GetClass()->GetStructureSize() + Weapon->GetResourceSizeBytes(EResourceSizeMode::Exclusive) };
+	for (const UActorComponent* Component : Weapon->GetComponents())
+	{
+		Bytes += Component->GetClass()->GetStructureSize() + Component->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+	}
+	Bytes = FMath::Max<int64>(Bytes - sizeof(FWeaponRecord), 0);
+
+	DehydratedClassBytes.Add(Weapon->GetClass(), Bytes);
+	return Bytes;
+}
+
+UTexture2D* AShooterCharacter::GetInventoryIcon(int32 SlotIndex) const
+{
+	if (!Inventory.IsValidIndex(SlotIndex) || Inventory[SlotIndex].IsEmpty()) return nullptr;
+
+	UShooterDataRegistry* DataRegistry = UShooterDataRegistry::Get();
+	const FWeaponDataTable* WeaponRow = DataRegistry ? DataRegistry->GetWeaponRow(Inventory[SlotIndex].WeaponType) : nullptr;
+	return WeaponRow ? WeaponRow->InventoryIcon.Get() : nullptr;
+}
+
 /* No longer Needed; AItem has GetInpterLocation()*/
 
 //FVector AShooterCharacter::GetCameraInterpLocation()
@@ -754,25 +1034,98 @@ void AShooterCharacter::GetPickupItem(AItem* Item)
 	auto Weapon = Cast<AWeapon>(Item);
 	if (Weapon)
 	{
-		if (Inventory.Num() < INVENTORY_CAPACITY)
+		const int32 Slot{ AllocateInventorySlot() };
+		if (Slot != -1)
 		{
-			Weapon->SetSlotIndex(Inventory.Num());
-			Inventory.Add(Weapon);
-			Weapon->SetItemState(EItemState::EIS_PickedUp);
+			Weapon->SetSlotIndex(Slot);
+			Inventory[Slot] = DehydrateWeapon(Weapon);
 		}
 		else //Inventory is full, swap with weapon
 		{
 			SwapWeapon(Weapon);
 		}
+		return;
 	}
 
 	auto Ammo = Cast<AAmmo>(Item);
 	if (Ammo)
 	{
 		PickupAmmo(Ammo);
+		return;
+	}
+
+	// Anything else is stacked by class and its actor goes back to the pool
+	const int32 Leftover{ AddToItemStacks(Item->GetClass(), FMath::Max(Item->GetItemCount(), 1)) };
+	if (Leftover > 0)
+	{
+		// Whatever didn't fit stays behind where the character stands
+		Item->SetItemCount(Leftover);
+		Item->SetActorLocation(GetActorLocation());
+		Item->SetItemState(EItemState::EIS_Pickup);
+	}
+	else
+	{
+		UPickupPoolSubsystem::DespawnPooledItem(Item);
 	}
 }
 
+int32 AShooterCharacter::AddToItemStacks(TSubclassOf<AItem> ItemClass, int32 Count)
+{
+	if (ItemClass == nullptr) return Count;
+
+	const int32 MaxStackSize{ FMath::Max(ItemClass->GetDefaultObject<AItem>()->GetMaxStackSize(), 1) };
+
+	// Top up the stacks already there first
+	for (FItemStack& Stack : ItemStacks)
+	{
+		if (Count == 0) break;
+		if (Stack.ItemClass != ItemClass || Stack.Count >= MaxStackSize) continue;
+
+		const int32 Added{ FMath::Min(Count, MaxStackSize - Stack.Count) };
+		Stack.Count += Added;
+		Count -= Added;
+	}
+
+	while (Count > 0)
+	{
+		const int32 Slot{ AllocateInventorySlot() };
+		if (Slot == -1) break;
+
+		ItemStacks[Slot].ItemClass = ItemClass;
+		ItemStacks[Slot].Count = FMath::Min(Count, MaxStackSize);
+		Count -= ItemStacks[Slot].Count;
+	}
+	return Count;
+}
+
+bool AShooterCharacter::ConsumeFromItemStack(int32 SlotIndex, int32 Count)
+{
+	if (Count <= 0 || !ItemStacks.IsValidIndex(SlotIndex) || ItemStacks[SlotIndex].Count < Count) return false;
+
+	ItemStacks[SlotIndex].Count -= Count;
+	if (ItemStacks[SlotIndex].Count == 0)
+	{
+		ItemStacks[SlotIndex] = FItemStack();
+		FreeInventorySlot(SlotIndex);
+	}
+	return true;
+}
+
+bool AShooterCharacter::HasInventoryRoomFor(const AItem* Item) const
+{
+	if (FreeSlotMask != 0) return true;
+	if (Cast<AWeapon>(Item) || Cast<AAmmo>(Item)) return false;
+
+	for (const FItemStack& Stack : ItemStacks)
+	{
+		if (Stack.ItemClass == Item->GetClass() && Stack.Count < Item->GetMaxStackSize())
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
 void AShooterCharacter::IntializeAmmoMap()
 {
 	AmmoMap.Add(EAmmoType::EAT_9mm, Starting9mmAmmo);
@@ -804,68 +1157,181 @@ void AShooterCharacter::SendBullet()
 
 		if (EquippedWeapon->GetMuzzleFlash())
 		{
-			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), EquippedWeapon->GetMuzzleFlash(), SocketTransform);
+			UEmitterPoolSubsystem::SpawnPooledEmitter(this, EquippedWeapon->GetMuzzleFlash(), SocketTransform);
+		}
+
+		// A refused round falls through to hitscan, which then reuses this crosshair trace
+		if (EquippedWeapon->GetFireMode() == EFireMode::EFM_Ballistic &&
+			FireProjectile(SocketTransform, GetCrosshairTrace().HitLocation))
+		{
+			return;
+		}
+
+		UHitscanSubsystem* HitscanSubsystem = GetWorld()->GetSubsystem<UHitscanSubsystem>();
+		if (bAsyncHitscan && HitscanSubsystem)
+		{
+			// Traces are resolved in a batch and come back through ApplyBulletHit
+			FVector CrosshairStart;
+			FVector CrosshairEnd;
+			if (IsCrosshairTraceFresh())
+			{
+				// Crosshair already traced this frame; only the barrel trace is left
+				HitscanSubsystem->QueueShotToTarget(this, EquippedWeapon, SocketTransform, GetCrosshairTrace().HitLocation);
+			}
+			else if (GetCrosshairRay(CrosshairStart, CrosshairEnd))
+			{
+				HitscanSubsystem->QueueShot(this, EquippedWeapon, SocketTransform, CrosshairStart, CrosshairEnd);
+			}
+			return;
 		}
 
 		FHitResult BeamHitResult;
 		bool bBeamEnd = GetBeamEndLocation(SocketTransform.GetLocation(), BeamHitResult);
 		if (bBeamEnd)
 		{
-			// Does hit actor implement BulletHitInterface
-			if (BeamHitResult.GetActor())
+			ApplyBulletHit(EquippedWeapon->GetBulletDamage(), SocketTransform, BeamHitResult);
+		}
+	}
+
+}
+
+void AShooterCharacter::SendBulletBatch(const TArray<FHitscanShotRequest>& Shots)
+{
+	if (EquippedWeapon && EquippedWeapon->GetFireMode() == EFireMode::EFM_Ballistic)
+	{
+		// Rounds the projectile subsystem refuses are still fired, as hitscan
+		TArray<FHitscanShotRequest> HitscanShots;
+		for (const FHitscanShotRequest& Shot : Shots)
+		{
+			if (!FireProjectile(Shot.SocketTransform, TraceCrosshairTarget(Shot.CrosshairStart, Shot.CrosshairEnd)))
 			{
-				IBulletHitInterface* BulletHitInterface = Cast<IBulletHitInterface>(BeamHitResult.GetActor());
-				if (BulletHitInterface)
-				{
-					BulletHitInterface->BulletHit_Implementation(BeamHitResult);
-				}
-
-				AEnemy* HitEnemy = Cast<AEnemy>(BeamHitResult.GetActor());
-				
-				if (HitEnemy)
-				{
-					int32 Damage{ 0 };
-					if (BeamHitResult.BoneName.ToString() == HitEnemy->GetHeadBone())
-					{
-						// Head shot
-						Damage = EquippedWeapon->GetHeadShotDamage();
-						UGameplayStatics::ApplyDamage(BeamHitResult.GetActor(),
-							EquippedWeapon->GetHeadShotDamage(),
-							GetController(),
-							this,
-							UDamageType::StaticClass());
-					}
-					else
-					{
-						// Body shot
-						Damage = EquippedWeapon->GetDamage();
-						UGameplayStatics::ApplyDamage(BeamHitResult.GetActor(),
-							EquippedWeapon->GetDamage(),
-							GetController(),
-							this,
-							UDamageType::StaticClass());
-					}
-					HitEnemy->ShowHitNumber(Damage, BeamHitResult.Location);
-				}
+				HitscanShots.Add(Shot);
 			}
-			else
+		}
+		SendHitscanBatch(HitscanShots);
+		return;
+	}
+
+	SendHitscanBatch(Shots);
+}
+
+void AShooterCharacter::SendHitscanBatch(const TArray<FHitscanShotRequest>& Shots)
+{
+	if (Shots.Num() == 0) return;
+
+	UHitscanSubsystem* HitscanSubsystem = GetWorld()->GetSubsystem<UHitscanSubsystem>();
+	if (bAsyncHitscan && HitscanSubsystem)
+	{
+		HitscanSubsystem->QueueShots(this, EquippedWeapon, Shots);
+		return;
+	}
+
+	for (const FHitscanShotRequest& Shot : Shots)
+	{
+		FHitResult BeamHitResult;
+		if (TraceBulletPath(Shot.SocketTransform, Shot.CrosshairStart, Shot.CrosshairEnd, BeamHitResult))
+		{
+			ApplyBulletHit(EquippedWeapon->GetBulletDamage(), Shot.SocketTransform, BeamHitResult);
+		}
+	}
+}
+
+bool AShooterCharacter::FireProjectile(const FTransform& SocketTransform, const FVector& AimLocation)
+{
+	UProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UProjectileSubsystem>();
+	if (EquippedWeapon == nullptr || ProjectileSubsystem == nullptr) return false;
+
+	// Straight at the crosshair target; drop is up to the player over distance
+	const FVector MuzzleLocation{ SocketTransform.GetLocation() };
+	const FVector Direction{ (AimLocation - MuzzleLocation).GetSafeNormal() };
+	return ProjectileSubsystem->FireRound(this, EquippedWeapon, MuzzleLocation, Direction * EquippedWeapon->GetMuzzleVelocity());
+}
+
+FVector AShooterCharacter::TraceCrosshairTarget(const FVector& CrosshairStart, const FVector& CrosshairEnd)
+{
+	FHitResult CrosshairHitResult;
+	if (GetWorld()->LineTraceSingleByChannel(CrosshairHitResult, CrosshairStart, CrosshairEnd, ECollisionChannel::ECC_Visibility))
+	{
+		return CrosshairHitResult.Location;
+	}
+	return CrosshairEnd;
+}
+
+bool AShooterCharacter::TraceBulletPath(const FTransform& SocketTransform, const FVector& CrosshairStart, const FVector& CrosshairEnd, FHitResult& OutHitResult)
+{
+	// Same traces as GetBeamEndLocation, from a given crosshair ray
+	const FVector BeamEndLocation{ TraceCrosshairTarget(CrosshairStart, CrosshairEnd) };
+
+	const FVector WeaponTraceStart{ SocketTransform.GetLocation() };
+	const FVector StartToEnd{ BeamEndLocation - WeaponTraceStart };
+	const FVector WeaponTraceEnd{ WeaponTraceStart + StartToEnd * 1.25f };
+	return GetWorld()->LineTraceSingleByChannel(OutHitResult, WeaponTraceStart, WeaponTraceEnd, ECollisionChannel::ECC_Visibility);
+}
+
+bool AShooterCharacter::GetBarrelSocketTransform(FTransform& OutSocketTransform) const
+{
+	if (EquippedWeapon == nullptr) return false;
+
+	const USkeletalMeshSocket* BarrelSocket = EquippedWeapon->GetItemMesh()->GetSocketByName("BarrelSocket");
+	if (BarrelSocket == nullptr) return false;
+
+	OutSocketTransform = BarrelSocket->GetSocketTransform(EquippedWeapon->GetItemMesh());
+	return true;
+}
+
+void AShooterCharacter::ApplyBulletHit(const FBulletDamage& BulletDamage, const FTransform& SocketTransform, const FHitResult& BeamHitResult)
+{
+	// Does hit actor implement BulletHitInterface
+	if (BeamHitResult.GetActor())
+	{
+		float ZoneDamage{ 0.f };
+		AEnemy* HitEnemy = Cast<AEnemy>(BeamHitResult.GetActor());
+		if (HitEnemy)
+		{
+			// Head, torso or limb from the enemy's body table
+			const EHitZone HitZone{ HitEnemy->GetHitZone(BeamHitResult) };
+			ZoneDamage = BulletDamage.GetZoneDamage(HitZone) * HitEnemy->GetHitZoneMultiplier(HitZone);
+		}
+
+		// Reactions, damage and numbers go out once per target at the end of the frame
+		if (UHitAggregationSubsystem* HitAggregation = GetWorld()->GetSubsystem<UHitAggregationSubsystem>())
+		{
+			HitAggregation->QueueHit(this, BeamHitResult, ZoneDamage);
+		}
+		else
+		{
+			IBulletHitInterface* BulletHitInterface = Cast<IBulletHitInterface>(BeamHitResult.GetActor());
+			if (BulletHitInterface)
 			{
-				// Spawn default particles
-				if (ImpactParticles)
-					{
-						UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticles, BeamHitResult.Location);
-					}
+				BulletHitInterface->BulletHitMerged_Implementation(BeamHitResult, 1, 0.f, GetController());
 			}
 
-			
-			UParticleSystemComponent* Beam = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), BeamParticles, SocketTransform);
-			if (Beam)
+			if (HitEnemy)
 			{
-				Beam->SetVectorParameter(FName("Target"), BeamHitResult.Location);
+				UGameplayStatics::ApplyDamage(HitEnemy,
+					ZoneDamage,
+					GetController(),
+					this,
+					UDamageType::StaticClass());
+				HitEnemy->ShowHitNumber(static_cast<int32>(ZoneDamage), BeamHitResult.Location);
 			}
 		}
 	}
+	else
+	{
+		// Spawn default particles
+		if (ImpactParticles)
+			{
+				UEmitterPoolSubsystem::SpawnPooledEmitter(this, ImpactParticles, FTransform(BeamHitResult.Location));
+			}
+	}
 
+	
+	UParticleSystemComponent* Beam = UEmitterPoolSubsystem::SpawnPooledEmitter(this, BeamParticles, SocketTransform);
+	if (Beam)
+	{
+		Beam->SetVectorParameter(FName("Target"), BeamHitResult.Location);
+	}
 }
 
 void AShooterCharacter::PlayGunfireMontage()
@@ -1085,7 +1551,7 @@ void AShooterCharacter::PickupAmmo(AAmmo* Ammo)
 			ReloadWeapon();
 		}
 	}
-	Ammo->Destroy();
+	UPickupPoolSubsystem::DespawnPooledItem(Ammo);
 }
 
 FInterpLocation AShooterCharacter::GetInterpLocation(int32 Index)
@@ -1124,20 +1590,35 @@ void AShooterCharacter::InitializeInterpLocations()
 
 int32 AShooterCharacter::GetInterpLocationIndex()
 {
-	int32 LowestIndex = 1;
-	int32 LowestCount = INT_MAX;
+	if (InterpLocations.Num() < 2) return 0;
+
+	// Every interp takes the same time, so handing slots out in turn keeps them as even as picking the emptiest
+	const int32 Index{ NextInterpLocIndex };
+	NextInterpLocIndex = NextInterpLocIndex + 1 < InterpLocations.Num() ? NextInterpLocIndex + 1 : 1;
+	return Index;
+}
+
+void AShooterCharacter::StartItemInterp(AItem* Item, int32 InterpLocIndex)
+{
+	ItemInterpBatch.Add(Item, InterpLocIndex, FollowCamera->GetComponentRotation().Yaw);
+}
+
+void AShooterCharacter::CancelItemInterp(AItem* Item)
+{
+	ItemInterpBatch.Remove(Item);
+}
 
-	for (int32 i = 1; i < InterpLocations.Num(); i++)
+void AShooterCharacter::UpdateItemInterps(float DeltaTime)
+{
+	if (ItemInterpBatch.Num() == 0) return;
+
+	InterpSlotLocations.Reset(InterpLocations.Num());
+	for (const FInterpLocation& InterpLocation : InterpLocations)
 	{
-		if (InterpLocations[i].ItemCount < LowestCount)
-		{
-			LowestIndex = i;
-			LowestCount = InterpLocations[i].ItemCount;
-		}
+		InterpSlotLocations.Add(InterpLocation.SceneComponent ? InterpLocation.SceneComponent->GetComponentLocation() : GetActorLocation());
 	}
 
-	return LowestIndex;
-	return int32();
+	ItemInterpBatch.Update(DeltaTime, InterpSlotLocations, FollowCamera->GetComponentRotation().Yaw);
 }
 
 void AShooterCharacter::IncrementInterpLocItemCount(int32 Index, int32 Amount)
@@ -1179,40 +1660,10 @@ void AShooterCharacter::ResetEquipSoundTimer()
 	bShouldPlayEquipSound = true;
 }
 
-void AShooterCharacter::FKeyPressed()
-{
-	if (EquippedWeapon->GetSlotIndex() == 0) return;
-	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 0);
-}
-
-void AShooterCharacter::OneKeyPressed()
-{
-	if (EquippedWeapon->GetSlotIndex() == 1) return;
-	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 1);
-}
-
-void AShooterCharacter::TwoKeyPressed()
-{
-	if (EquippedWeapon->GetSlotIndex() == 2) return;
-	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 2);
-}
-
-void AShooterCharacter::ThreeKeyPressed()
-{
-	if (EquippedWeapon->GetSlotIndex() == 3) return;
-	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 3);
-}
-
-void AShooterCharacter::FourKeyPressed()
-{
-	if (EquippedWeapon->GetSlotIndex() == 4) return;
-	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 4);
-}
-
-void AShooterCharacter::FiveKeyPressed()
+void AShooterCharacter::InventorySlotPressed(int32 SlotIndex)
 {
-	if (EquippedWeapon->GetSlotIndex() == 5) return;
-	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 5);
+	if (EquippedWeapon == nullptr || EquippedWeapon->GetSlotIndex() == SlotIndex) return;
+	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), SlotIndex);
 }
 
 void AShooterCharacter::ExchangeInventoryItems(int32 CurrentItemIndex, int32 NewItemIndex)
@@ -1221,6 +1672,7 @@ void AShooterCharacter::ExchangeInventoryItems(int32 CurrentItemIndex, int32 New
 	const bool bCanExchangeItems = 
 		(CurrentItemIndex != NewItemIndex) &&
 		(NewItemIndex < Inventory.Num()) &&
+		!Inventory[NewItemIndex].IsEmpty() &&
 		(CombatState == ECombatState::ECS_Unoccupied || CombatState == ECombatState::ECS_Equipping);
 
 	if (bCanExchangeItems)
@@ -1230,11 +1682,13 @@ void AShooterCharacter::ExchangeInventoryItems(int32 CurrentItemIndex, int32 New
 			StopAiming();
 		}
 		auto OldEquippedWeapon = EquippedWeapon;
-		auto NewWeapon = Cast<AWeapon>(Inventory[NewItemIndex]);
+		auto NewWeapon = HydrateWeapon(Inventory[NewItemIndex]);
+		if (NewWeapon == nullptr) return;
 		EquipWeapon(NewWeapon);
 
-		OldEquippedWeapon->SetItemState(EItemState::EIS_PickedUp);
-		NewWeapon->SetItemState(EItemState::EIS_Equipped);
+		// The equipped slot keeps a placeholder record; it is refreshed when the weapon is put away
+		Inventory[CurrentItemIndex] = DehydrateWeapon(OldEquippedWeapon);
+		Inventory[NewItemIndex] = NewWeapon->MakeRecord();
 
 		CombatState = ECombatState::ECS_Equipping;
 		UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
@@ -1248,21 +1702,27 @@ void AShooterCharacter::ExchangeInventoryItems(int32 CurrentItemIndex, int32 New
 	
 }
 
-int32 AShooterCharacter::GetEmptyInventorySlot()
+int32 AShooterCharacter::GetEmptyInventorySlot() const
 {
-	for (int32 i = 0; i < Inventory.Num(); i++)
+	return FreeSlotMask != 0 ? FMath::CountTrailingZeros64(FreeSlotMask) : -1; // -1 if the inventory is full
+}
+
+int32 AShooterCharacter::AllocateInventorySlot()
+{
+	const int32 Slot{ GetEmptyInventorySlot() };
+	if (Slot != -1)
 	{
-		if (Inventory[i] == nullptr)
-		{
-			return i;
-		}
+		FreeSlotMask &= ~(uint64(1) << Slot);
 	}
-	if (Inventory.Num() < INVENTORY_CAPACITY)
+	return Slot;
+}
+
+void AShooterCharacter::FreeInventorySlot(int32 SlotIndex)
+{
+	if (SlotIndex >= 0 && SlotIndex < InventoryCapacity)
 	{
-		return Inventory.Num();
+		FreeSlotMask |= uint64(1) << SlotIndex;
 	}
-
-	return -1; // Inventory is full
 }
 
 void AShooterCharacter::HighlightInventorySlot()
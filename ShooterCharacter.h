@@ -5,6 +5,9 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "AmmoType.h"
+#include "FireScheduler.h"
+#include "ItemInterpBatch.h"
+#include "Weapon.h"
 #include "ShooterCharacter.generated.h"
 
 UENUM(BlueprintType)
@@ -33,10 +36,33 @@ struct FInterpLocation
 	int32 ItemCount;
 };
 
+/* Crosshair trace result shared by everything that needs it in a frame*/
+USTRUCT(BlueprintType)
+struct FCrosshairTraceResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FHitResult HitResult;
+
+	/* Hit location, or the end of the trace if nothing was hit*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FVector HitLocation = FVector::ZeroVector;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	bool bHit = false;
+
+	/* Frame and camera transform the trace was made with*/
+	uint64 FrameNumber = 0;
+	FTransform CameraTransform;
+};
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FEquipItemDelegate, int32, CurrentSlotIndex, int32, NewSlotIndex);
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FHighlightIconDelegate, int32, slotIndex, bool, bStartAnimation);
 
+DECLARE_DELEGATE_OneParam(FInventorySlotInputDelegate, int32);
+
 UCLASS()
 class SHOOTER_API AShooterCharacter : public ACharacter
 {
@@ -50,6 +76,8 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	/** Called for forward/backward input*/
 	void MoveForward(float Value);
 
@@ -97,17 +125,39 @@ protected:
 
 	void FireButtonReleased();
 
+	/** Start the fire scheduler after a shot; the weapon can't fire again until it comes due*/
 	void StartFireTimer();
 
-	UFUNCTION()
-	void AutoFireReset();
+	/** Fire every automatic shot that came due this frame, interpolating the muzzle and aim between frames*/
+	void UpdateAutoFire(float DeltaTime);
 
-	/** Line trace for items under the crosshairs*/
-	bool TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation);
+	/** Trace a batch of shots, async if enabled*/
+	void SendBulletBatch(const TArray<struct FHitscanShotRequest>& Shots);
+
+	/** Hitscan half of SendBulletBatch*/
+	void SendHitscanBatch(const TArray<struct FHitscanShotRequest>& Shots);
+
+	/** Launches a ballistic round from the barrel toward AimLocation. False if it has to be hitscan*/
+	bool FireProjectile(const FTransform& SocketTransform, const FVector& AimLocation);
 
-	/** Trace for items if overlapped item count is greater than zero*/
+	/** Blocking crosshair trace along a given ray; the hit location, or CrosshairEnd if nothing was hit*/
+	FVector TraceCrosshairTarget(const FVector& CrosshairStart, const FVector& CrosshairEnd);
+
+	/** Blocking crosshair and barrel traces along a given crosshair ray*/
+	bool TraceBulletPath(const FTransform& SocketTransform, const FVector& CrosshairStart, const FVector& CrosshairEnd, FHitResult& OutHitResult);
+
+	/** World transform of the equipped weapon's barrel socket*/
+	bool GetBarrelSocketTransform(FTransform& OutSocketTransform) const;
+
+	/** Deproject the centre of the viewport into the crosshair trace start and end*/
+	bool GetCrosshairRay(FVector& OutStart, FVector& OutEnd);
+
+	/** Update which pickups are in range and focus the one in the crosshair view cone, from the pickup index*/
 	void TraceForItems();
 
+	/** Moves the pickup popup to Item, or hides it if Item is null*/
+	void ShowPickupWidget(AItem* Item);
+
 	/** Spawns a default weapon and equips it*/
 	class AWeapon* SpawnDefaultWeapon();
 
@@ -123,6 +173,15 @@ protected:
 	/** Drops currently equipped weapon and equips TraceHitItem*/
 	void SwapWeapon(AWeapon* WeaponToSwap);
 
+	/** Turns an inventory weapon into a record and destroys its actor*/
+	FWeaponRecord DehydrateWeapon(AWeapon* Weapon);
+
+	/** Gets an actor for Record from the pickup pool, held by this character but not equipped*/
+	AWeapon* HydrateWeapon(const FWeaponRecord& Record);
+
+	/** Memory an actor of Weapon's class takes beyond the record that replaces it*/
+	int64 GetDehydratedWeaponSavings(const AWeapon* Weapon);
+
 	/** Intialize the ammo map with the ammo values*/
 	void IntializeAmmoMap();
 
@@ -131,6 +190,9 @@ protected:
 	void SendBullet();
 	void PlayGunfireMontage();
 
+	/** Everything a shot does besides the bullet: fire sound, montage, ammo, crosshair spread and pistol slide*/
+	void ConsumeShot();
+
 	/** Bound to the R key and the gamepad face button left*/
 	void ReloadButtonPressed();
 
@@ -169,16 +231,26 @@ protected:
 
 	void InitializeInterpLocations();
 
-	void FKeyPressed();
-	void OneKeyPressed();
-	void TwoKeyPressed();
-	void ThreeKeyPressed();
-	void FourKeyPressed();
-	void FiveKeyPressed();
+	/* Moves every interping pickup*/
+	void UpdateItemInterps(float DeltaTime);
+
+	/* Bound to every action in InventorySlotActions*/
+	void InventorySlotPressed(int32 SlotIndex);
 
 	void ExchangeInventoryItems(int32 CurrentItemIndex, int32 NewItemIndex);
 
-	int32 GetEmptyInventorySlot();
+	int32 GetEmptyInventorySlot() const;
+
+	/* Marks the lowest free slot as used. -1 if the inventory is full*/
+	int32 AllocateInventorySlot();
+
+	void FreeInventorySlot(int32 SlotIndex);
+
+	/* Adds Count of ItemClass to its stacks, opening new slots as needed. Returns how many didn't fit*/
+	int32 AddToItemStacks(TSubclassOf<AItem> ItemClass, int32 Count);
+
+	/* True if Item fits without swapping: a free slot, or for stacked items room on one of its stacks*/
+	bool HasInventoryRoomFor(const AItem* Item) const;
 
 	void HighlightInventorySlot();
 
@@ -255,6 +327,21 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
 	UParticleSystem* BeamParticles;
 
+	/** True to resolve shots through the async trace API; false for the blocking traces*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
+	bool bAsyncHitscan;
+
+	/** Particle components created up front for the impact, beam and muzzle flash pools*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
+	int32 EmitterPoolPrewarmCount;
+
+	/** Most automatic shots fired in one frame; a longer hitch drops the rest*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
+	int32 MaxShotsPerFrame;
+
+	/** Pre-warm the emitter pools for particles spawned every shot*/
+	void PrewarmEmitterPools();
+
 	/** True when aiming*/
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat", meta = (AllowPrivateAccess = "true"))
 	bool bAiming;
@@ -308,14 +395,42 @@ private:
 	/** True when we can fire, false when waiting for the timer*/
 	bool bShouldFire;
 
-	/** Set a timer between gunshots*/
-	FTimerHandle AutoFireTimer;
+	/** Time between gunshots, carried across frames*/
+	FFireScheduler FireScheduler;
 
-	/** True is we should trace every frame for items*/
-	bool bShouldTraceForItems;
+	/** Shot times for this frame from FireScheduler*/
+	TArray<float> ScheduledShotAlphas;
 
-	/** Number of overlapped AItems*/
-	int8 OverlappedItemCount;
+	/** Barrel transform and crosshair ray at the end of last frame, for interpolating shots*/
+	FTransform LastFireSocketTransform;
+	FVector LastFireCrosshairStart;
+	FVector LastFireCrosshairEnd;
+
+	/** Half angle of the cone around the crosshair that pickups are focused in*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Items", meta = (AllowPrivateAccess = true))
+	float PickupViewConeAngle;
+
+	/** The one pickup popup this player has; moved to whichever item is focused*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Items", meta = (AllowPrivateAccess = true))
+	class UWidgetComponent* PickupWidgetComponent;
+
+	/** Widget shown by PickupWidgetComponent*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Items", meta = (AllowPrivateAccess = true))
+	TSubclassOf<class UItemPickupWidget> PickupWidgetClass;
+
+	/** Offset from the focused item's origin to the popup*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Items", meta = (AllowPrivateAccess = true))
+	FVector PickupWidgetOffset;
+
+	/** Item PickupWidgetComponent is showing, if any*/
+	UPROPERTY()
+	AItem* PickupWidgetItem;
+
+	/** Last crosshair trace; reused while the frame and camera transform match*/
+	FCrosshairTraceResult CrosshairTraceCache;
+
+	/** Number of crosshair traces answered from the cache on CrosshairTraceCache's frame*/
+	int32 CrosshairTracesSaved;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Items", meta = (AllowPrivateAccess = true))
 	class AItem* TraceHitItemLastFrame;
@@ -328,7 +443,7 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = true))
 	TSubclassOf<AWeapon> DefaultWeaponClass;
 
-	/** The item currently hit by our trace in TraceForItems (could be null)*/
+	/** The pickup currently focused by TraceForItems (could be null)*/
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat", meta = (AllowPrivateAccess = true))
 	AItem* TraceHitItem;
 
@@ -435,6 +550,15 @@ private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	TArray<FInterpLocation> InterpLocations;
 
+	/* Next item interp location handed out; skips 0, which is the weapon's*/
+	int32 NextInterpLocIndex;
+
+	/* Pickups flying toward the camera*/
+	FItemInterpBatch ItemInterpBatch;
+
+	/* World location of each interp location, gathered once a frame for ItemInterpBatch*/
+	TArray<FVector> InterpSlotLocations;
+
 	FTimerHandle PickupSoundTimer;
 	FTimerHandle EquipSoundTimer;
 
@@ -452,11 +576,30 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Items", meta = (AllowPrivateAccess = true))
 	float EquipSoundResetTime;
 
-	/* An Array of AItems for our inventory*/
+	/* Inventory slots. Only the equipped weapon has an actor; its record is refreshed when it is put away*/
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory", meta = (AllowPrivateAccess = true))
-	TArray<AItem*> Inventory;
+	TArray<FWeaponRecord> Inventory;
 
-	const int32 INVENTORY_CAPACITY{ 6 };
+	/* Memory saved by keeping the unequipped inventory as records*/
+	int64 DehydratedBytesSaved;
+
+	/* GetDehydratedWeaponSavings by weapon class, measured on first use*/
+	TMap<TWeakObjectPtr<const UClass>, int64> DehydratedClassBytes;
+
+	/* Non-weapon stacks, by inventory slot. A slot holds a weapon record or a stack, never both*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory", meta = (AllowPrivateAccess = true))
+	TArray<FItemStack> ItemStacks;
+
+	/* Number of inventory slots*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Inventory", meta = (AllowPrivateAccess = true, ClampMin = 1, ClampMax = 64))
+	int32 InventoryCapacity;
+
+	/* One bit per inventory slot, set while the slot is free*/
+	uint64 FreeSlotMask;
+
+	/* Input actions selecting inventory slots, in slot order*/
+	UPROPERTY(EditDefaultsOnly, Category = "Inventory", meta = (AllowPrivateAccess = true))
+	TArray<FName> InventorySlotActions;
 
 	/* Delegate for sending slot informaiton to InventoryBar when equipping*/
 	UPROPERTY(BlueprintAssignable, Category = "Delegates", meta = (AllowPrivateAccess = true))
@@ -482,10 +625,19 @@ public:
 	UFUNCTION(BlueprintCallable)
 	float GetCrosshairSpreadMulitplier() const;
 
-	FORCEINLINE int8 GetOverlappedItemCount() const { return OverlappedItemCount;}
+	/** Line trace for items under the crosshairs. Traces at most once per frame and camera transform*/
+	UFUNCTION(BlueprintCallable)
+	bool TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation);
+
+	/** Returns this frame's crosshair trace, tracing if it has not been done yet*/
+	const FCrosshairTraceResult& GetCrosshairTrace();
 
-	/** Adds/subtracts to/from overlapped item count and updates bShouldTraceForItems*/
-	void IncrementOverlappedItemCount(int8 Amount);
+	/** True if the cached crosshair trace was made this frame from the current camera transform*/
+	bool IsCrosshairTraceFresh() const;
+
+	/** Number of crosshair traces saved by the cache this frame*/
+	UFUNCTION(BlueprintCallable)
+	int32 GetCrosshairTracesSavedThisFrame() const;
 
 	// No longer need. AItem had GetInterpLocation()
 	//FVector GetCameraInterpLocation();
@@ -498,9 +650,15 @@ public:
 
 	FInterpLocation GetInterpLocation(int32 Index);
 
-	/* Returns the index in Interpolations array with the lowest ItemCount*/
+	/* Returns the next item interp location, round robin*/
 	int32 GetInterpLocationIndex();
 
+	/* Starts flying Item toward the interp location at InterpLocIndex*/
+	void StartItemInterp(AItem* Item, int32 InterpLocIndex);
+
+	/* Stops flying Item without finishing the pickup*/
+	void CancelItemInterp(AItem* Item);
+
 	void IncrementInterpLocItemCount(int32 Index, int32 Amount);
 
 	FORCEINLINE bool ShouldPlayPickupSound() const { return bShouldPlayPickupSound; }
@@ -508,9 +666,24 @@ public:
 
 	FORCEINLINE AWeapon* GetEquippedWeapon() const { return EquippedWeapon;  }
 
+	/* Bytes saved by holding unequipped weapons as records instead of actors*/
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	FORCEINLINE int64 GetDehydratedBytesSaved() const { return DehydratedBytesSaved; }
+
+	/* Inventory bar icon for a slot; null for an empty slot or while the icon is still streaming*/
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	UTexture2D* GetInventoryIcon(int32 SlotIndex) const;
+
+	/* Uses Count items from the stack in SlotIndex, freeing the slot when it empties. False if there aren't enough*/
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	bool ConsumeFromItemStack(int32 SlotIndex, int32 Count);
+
 	void StartPickupSoundTimer();
 	void StartEquipSoundTimer();
 
+	/** Applies damage, impact particles and the beam for a shot whose barrel trace hit something*/
+	void ApplyBulletHit(const FBulletDamage& BulletDamage, const FTransform& SocketTransform, const FHitResult& BeamHitResult);
+
 
 	void UnhighlightInventorySlot();
 };
@@ -0,0 +1,149 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterDataRegistry.h"
+#include "Engine/DataTable.h"
+#include "Engine/Engine.h"
+#include "UObject/UObjectIterator.h"
+#include "Weapon.h"
+
+namespace
+{
+	/* Row name for each EWeaponType*/
+	const FName WeaponRowNames[] =
+	{
+		FName(TEXT("SubmachineGun")),
+		FName(TEXT("AssaultRifle")),
+		FName(TEXT("Pistol"))
+	};
+	static_assert(UE_ARRAY_COUNT(WeaponRowNames) == static_cast<int32>(EWeaponType::EWT_MAX), "Add a row name for each EWeaponType");
+
+	/* Row name for each EItemRarity*/
+	const FName RarityRowNames[] =
+	{
+		FName(TEXT("Damaged")),
+		FName(TEXT("Common")),
+		FName(TEXT("Uncommon")),
+		FName(TEXT("Rare")),
+		FName(TEXT("Legendary"))
+	};
+	static_assert(UE_ARRAY_COUNT(RarityRowNames) == static_cast<int32>(EItemRarity::EIR_MAX), "Add a row name for each EItemRarity");
+}
+
+void UShooterDataRegistry::Deinitialize()
+{
+#if WITH_EDITOR
+	if (WeaponDataTable)
+	{
+		WeaponDataTable->OnDataTableChanged().RemoveAll(this);
+	}
+	if (ItemRarityDataTable)
+	{
+		ItemRarityDataTable->OnDataTableChanged().RemoveAll(this);
+	}
+#endif
+
+	WeaponRows.Empty();
+	RarityRows.Empty();
+	WeaponDataTable = nullptr;
+	ItemRarityDataTable = nullptr;
+	bTablesLoaded = false;
+
+	Super::Deinitialize();
+}
+
+UShooterDataRegistry* UShooterDataRegistry::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UShooterDataRegistry>() : nullptr;
+}
+
+const FWeaponDataTable* UShooterDataRegistry::GetWeaponRow(EWeaponType WeaponType)
+{
+	LoadTables();
+
+	const int32 Index{ static_cast<int32>(WeaponType) };
+	return WeaponRows.IsValidIndex(Index) ? WeaponRows[Index] : nullptr;
+}
+
+const FItemRarityTable* UShooterDataRegistry::GetRarityRow(EItemRarity Rarity)
+{
+	LoadTables();
+
+	const int32 Index{ static_cast<int32>(Rarity) };
+	return RarityRows.IsValidIndex(Index) ? RarityRows[Index] : nullptr;
+}
+
+void UShooterDataRegistry::LoadTables()
+{
+	if (bTablesLoaded) return;
+	bTablesLoaded = true;
+
+	WeaponDataTable = Cast<UDataTable>(WeaponDataTablePath.TryLoad());
+	ItemRarityDataTable = Cast<UDataTable>(ItemRarityDataTablePath.TryLoad());
+
+#if WITH_EDITOR
+	if (WeaponDataTable)
+	{
+		WeaponDataTable->OnDataTableChanged().AddUObject(this, &UShooterDataRegistry::OnWeaponTableChanged);
+	}
+	if (ItemRarityDataTable)
+	{
+		ItemRarityDataTable->OnDataTableChanged().AddUObject(this, &UShooterDataRegistry::OnRarityTableChanged);
+	}
+#endif
+
+	CacheWeaponRows();
+	CacheRarityRows();
+}
+
+void UShooterDataRegistry::CacheWeaponRows()
+{
+	WeaponRows.Init(nullptr, static_cast<int32>(EWeaponType::EWT_MAX));
+	if (WeaponDataTable == nullptr) return;
+
+	for (int32 i = 0; i < WeaponRows.Num(); i++)
+	{
+		WeaponRows[i] = WeaponDataTable->FindRow<FWeaponDataTable>(WeaponRowNames[i], TEXT("UShooterDataRegistry"));
+	}
+}
+
+void UShooterDataRegistry::CacheRarityRows()
+{
+	RarityRows.Init(nullptr, static_cast<int32>(EItemRarity::EIR_MAX));
+	if (ItemRarityDataTable == nullptr) return;
+
+	for (int32 i = 0; i < RarityRows.Num(); i++)
+	{
+		RarityRows[i] = ItemRarityDataTable->FindRow<FItemRarityTable>(RarityRowNames[i], TEXT("UShooterDataRegistry"));
+	}
+}
+
+#if WITH_EDITOR
+void UShooterDataRegistry::OnWeaponTableChanged()
+{
+	CacheWeaponRows();
+	RerunItemConstructionScripts();
+}
+
+void UShooterDataRegistry::OnRarityTableChanged()
+{
+	CacheRarityRows();
+	RerunItemConstructionScripts();
+}
+
+void UShooterDataRegistry::RerunItemConstructionScripts()
+{
+	// Placed items copied their rows at construction; running it again picks up the edit
+	for (TObjectIterator<AItem> It; It; ++It)
+	{
+		AItem* Item = *It;
+		if (Item->IsTemplate()) continue;
+
+		UWorld* World = Item->GetWorld();
+		if (World && !World->IsGameWorld())
+		{
+			Item->RerunConstructionScripts();
+		}
+	}
+}
+#endif
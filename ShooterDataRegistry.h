@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Item.h"
+#include "WeaponType.h"
+#include "ShooterDataRegistry.generated.h"
+
+struct FWeaponDataTable;
+class UDataTable;
+
+/**
+ * Loads the weapon and item rarity data tables once and hands out their rows
+ * by enum, so constructing an item is an array lookup instead of a load and a FindRow.
+ * An engine subsystem rather than a game instance one so editor construction scripts use it too.
+ */
+UCLASS(Config = Game)
+class SHOOTER_API UShooterDataRegistry : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	/* The registry, or nullptr before the engine is up*/
+	static UShooterDataRegistry* Get();
+
+	/* Row for WeaponType, or nullptr if the table doesn't have one*/
+	const FWeaponDataTable* GetWeaponRow(EWeaponType WeaponType);
+
+	/* Row for Rarity, or nullptr if the table doesn't have one*/
+	const FItemRarityTable* GetRarityRow(EItemRarity Rarity);
+
+private:
+
+	/* Loads both tables the first time a row is asked for*/
+	void LoadTables();
+
+	/* Resolves each enum value's row once into the dense row arrays*/
+	void CacheWeaponRows();
+	void CacheRarityRows();
+
+#if WITH_EDITOR
+	/* Recaches rows and reruns construction scripts of editor items after a table is edited or reimported*/
+	void OnWeaponTableChanged();
+	void OnRarityTableChanged();
+
+	void RerunItemConstructionScripts();
+#endif
+
+	UPROPERTY(Config)
+	FSoftObjectPath WeaponDataTablePath{ TEXT("/Game/_Game/DataTable/WeaponDataTable.WeaponDataTable") };
+
+	UPROPERTY(Config)
+	FSoftObjectPath ItemRarityDataTablePath{ TEXT("/Game/_Game/DataTable/ItemRarityDataTable.ItemRarityDataTable") };
+
+	UPROPERTY()
+	UDataTable* WeaponDataTable;
+
+	UPROPERTY()
+	UDataTable* ItemRarityDataTable;
+
+	/* Indexed by EWeaponType*/
+	TArray<const FWeaponDataTable*> WeaponRows;
+
+	/* Indexed by EItemRarity*/
+	TArray<const FItemRarityTable*> RarityRows;
+
+	bool bTablesLoaded = false;
+};
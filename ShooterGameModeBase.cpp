@@ -2,4 +2,11 @@
 
 
 #include "ShooterGameModeBase.h"
+#include "ShooterHUD.h"
+
+AShooterGameModeBase::AShooterGameModeBase()
+{
+	// Draws the enemy health bars
+	HUDClass = AShooterHUD::StaticClass();
+}
 
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterHUD.h"
+#include "Engine/Canvas.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "HealthBarSubsystem.h"
+#include "Enemy.h"
+
+AShooterHUD::AShooterHUD() :
+	HealthBarSize(FVector2D(80.f, 8.f)),
+	HealthBarOffset(20.f),
+	HealthBarBackgroundColor(FLinearColor(0.f, 0.f, 0.f, 0.6f)),
+	HealthBarFillColor(FLinearColor(0.8f, 0.05f, 0.05f, 1.f)),
+	HealthBarRenderedTime(0.1f)
+{
+
+}
+
+void AShooterHUD::DrawHUD()
+{
+	Super::DrawHUD();
+
+	DrawHealthBars();
+}
+
+void AShooterHUD::DrawHealthBars()
+{
+	UHealthBarSubsystem* HealthBarSubsystem = GetWorld()->GetSubsystem<UHealthBarSubsystem>();
+	if (HealthBarSubsystem == nullptr || Canvas == nullptr) return;
+
+	HealthBarSubsystem->RemoveExpired(GetWorld()->GetTimeSeconds());
+
+	const float Scale{ Canvas->ClipY / 1080.f };
+	const FVector2D Size{ HealthBarSize * Scale };
+
+	for (const FHealthBarEntry& Entry : HealthBarSubsystem->GetHealthBars())
+	{
+		const AEnemy* Enemy = Entry.Enemy;
+
+		// Occluded and off screen enemies weren't rendered last frame
+		if (!IsValid(Enemy) || !Enemy->WasRecentlyRendered(HealthBarRenderedTime)) continue;
+
+		const FBoxSphereBounds& Bounds = Enemy->GetMesh()->Bounds;
+		const FVector WorldLocation{ Bounds.Origin + FVector(0.f, 0.f, Bounds.BoxExtent.Z + HealthBarOffset) };
+
+		// Project leaves Z at zero for points behind the camera
+		const FVector ScreenLocation{ Project(WorldLocation, true) };
+		if (ScreenLocation.Z <= 0.f) continue;
+
+		const float Left{ static_cast<float>(ScreenLocation.X) - Size.X * 0.5f };
+		const float Top{ static_cast<float>(ScreenLocation.Y) - Size.Y };
+		if (Left + Size.X < 0.f || Left > Canvas->ClipX || Top + Size.Y < 0.f || Top > Canvas->ClipY) continue;
+
+		// Untextured rects share one batch on the canvas
+		DrawRect(HealthBarBackgroundColor, Left, Top, Size.X, Size.Y);
+		DrawRect(HealthBarFillColor, Left, Top, Size.X * Entry.HealthFraction, Size.Y);
+	}
+}
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/HUD.h"
+#include "ShooterHUD.generated.h"
+
+/**
+ * Native HUD layer under the Blueprint overlay.
+ * Draws every enemy health bar from UHealthBarSubsystem in one pass over the canvas.
+ */
+UCLASS()
+class SHOOTER_API AShooterHUD : public AHUD
+{
+	GENERATED_BODY()
+
+public:
+
+	AShooterHUD();
+
+	virtual void DrawHUD() override;
+
+protected:
+
+	/* Draws the bars that are on screen and were rendered recently*/
+	void DrawHealthBars();
+
+private:
+
+	/* Bar size in pixels at a 1080 pixel tall viewport*/
+	UPROPERTY(EditAnywhere, Category = "Health Bars", meta = (AllowPrivateAccess = "true"))
+	FVector2D HealthBarSize;
+
+	/* Height of the bar above the enemy's bounds*/
+	UPROPERTY(EditAnywhere, Category = "Health Bars", meta = (AllowPrivateAccess = "true"))
+	float HealthBarOffset;
+
+	UPROPERTY(EditAnywhere, Category = "Health Bars", meta = (AllowPrivateAccess = "true"))
+	FLinearColor HealthBarBackgroundColor;
+
+	UPROPERTY(EditAnywhere, Category = "Health Bars", meta = (AllowPrivateAccess = "true"))
+	FLinearColor HealthBarFillColor;
+
+	/* An enemy not rendered within this many seconds is occluded or off screen; its bar is skipped*/
+	UPROPERTY(EditAnywhere, Category = "Health Bars", meta = (AllowPrivateAccess = "true"))
+	float HealthBarRenderedTime;
+};
@@ -2,6 +2,8 @@
 
 
 #include "Weapon.h"
+#include "ShooterDataRegistry.h"
+#include "WeaponAssetStreamer.h"
 
 AWeapon::AWeapon() :
 
@@ -18,10 +20,16 @@ SlideDisplacementTime(0.2f),
 bMovingSlide(false),
 MaxSlideDisplacement(4.f),
 MaxRecoilRotation(20.f),
-bAutomatic(true)
+bAutomatic(true),
+LimbDamage(0.f),
+FireMode(EFireMode::EFM_Hitscan),
+MuzzleVelocity(60000.f),
+GravityScale(1.f),
+PickupAssetsType(EWeaponType::EWT_MAX),
+EquipAssetsType(EWeaponType::EWT_MAX)
 
 {
-  // Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
+	// Ticks while thrown or moving the slide; see ShouldTick
 	PrimaryActorTick.bCanEverTick = true;
 }
 
@@ -55,6 +63,7 @@ void AWeapon::ThrowWeapon()
     ImpulseDirection *= 5'000.f;
     GetItemMesh()->AddImpulse(ImpulseDirection);
     bFalling = true;
+    UpdateTickState();
     GetWorldTimerManager().SetTimer(ThrowWeaponTimer, this, &AWeapon::StopFalling, ThrowWeaponTime);
 
     EnableGlowMaterial();
@@ -64,90 +73,176 @@ void AWeapon::StopFalling()
 {
     bFalling = false;
     SetItemState(EItemState::EIS_Pickup);
-    StartPulseTimer();
 }
 
 void AWeapon::OnConstruction(const FTransform& Transform)
 {
     Super::OnConstruction(Transform);
 
-    const FString WeaponTablePath(TEXT("DataTable'/Game/_Game/DataTable/WeaponDataTable.WeaponDataTable'"));
-    UDataTable* WeaponTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, *WeaponTablePath));
+    ApplyWeaponData();
 
-    if (WeaponTableObject)
+    // In game the assets are streamed in from BeginPlay; the editor shows everything right away
+    const FWeaponDataTable* WeaponData = GetWeaponData();
+    if (WeaponData && GetWorld() && !GetWorld()->IsGameWorld())
     {
-        FWeaponDataTable* WeaponDataRow = nullptr;
-        switch (WeaponType)
-        {
-        case EWeaponType::EWT_SubmachineGun :
-
-            WeaponDataRow = WeaponTableObject->FindRow<FWeaponDataTable>(FName("SubmachineGun"), TEXT(""));
-           break;
-
-        case EWeaponType::EWT_AssaultRifle :
-
-            WeaponDataRow = WeaponTableObject->FindRow<FWeaponDataTable>(FName("AssaultRifle"), TEXT(""));
-
-            break;
-
-        case EWeaponType::EWT_Pistol :
+        UWeaponAssetStreamer::LoadRowSynchronous(*WeaponData);
+        ApplyPickupAssets();
+        ApplyEquipAssets();
+    }
+}
 
-            WeaponDataRow = WeaponTableObject->FindRow<FWeaponDataTable>(FName("Pistol"), TEXT(""));
+void AWeapon::ApplyWeaponData()
+{
+    UShooterDataRegistry* DataRegistry = UShooterDataRegistry::Get();
 
-            break;
-        }
+    if (DataRegistry)
+    {
+        const FWeaponDataTable* WeaponDataRow = DataRegistry->GetWeaponRow(WeaponType);
 
         if (WeaponDataRow)
         {
             AmmoType = WeaponDataRow->AmmoType;
             Ammo = WeaponDataRow->WeaponAmmo;
             MagazineCapacity = WeaponDataRow->MagazineCapacity;
-            SetPickupSound(WeaponDataRow->PickupSound);
-            SetEquipSound(WeaponDataRow->EquipSound);
-            GetItemMesh()->SetSkeletalMesh(WeaponDataRow->ItemMesh);
             SetItemName(WeaponDataRow->ItemName);
-            SetIconItem(WeaponDataRow->InventoryIcon);
-            SetAmmoIcon(WeaponDataRow->AmmoIcon);
 
-            SetMaterialInstance(WeaponDataRow->MaterialInstance);
             PreviousMaterialIndex = GetMaterialIndex();
             GetItemMesh()->SetMaterial(PreviousMaterialIndex, nullptr);
             SetMaterialIndex(WeaponDataRow->MaterialIndex);
             SetClipBoneName(WeaponDataRow->ClipBoneName);
             SetReloadMontageSection(WeaponDataRow->ReloadMontageSection);
-            GetItemMesh()->SetAnimInstanceClass(WeaponDataRow->AnimBP);
-            CrosshairsMiddle = WeaponDataRow->CrosshairsMiddle;
-            CrosshairsLeft = WeaponDataRow->CrosshairsLeft;
-            CrosshairsRight = WeaponDataRow->CrosshairsRight;
-            CrosshairsTop = WeaponDataRow->CrosshairsTop;
-            CrosshairsBottom = WeaponDataRow->CrosshairsBottom;
             AutoFireRate = WeaponDataRow->AutoFireRate;
-            MuzzleFlash = WeaponDataRow->MuzzleFlash;
-            FireSound = WeaponDataRow->FireSound;
             BoneToHide = WeaponDataRow->BoneToHide;
             bAutomatic = WeaponDataRow->bAutomatic;
             Damage = WeaponDataRow->Damage;
             HeadShotDamage = WeaponDataRow->HeadShotDamage;
-
+            LimbDamage = WeaponDataRow->LimbDamage;
+            FireMode = WeaponDataRow->FireMode;
+            MuzzleVelocity = WeaponDataRow->MuzzleVelocity;
+            GravityScale = WeaponDataRow->GravityScale;
         }
+    }
+}
 
-        if (GetMaterialInstance())
-        {
-            SetDynamicMaterialInstance(UMaterialInstanceDynamic::Create(GetMaterialInstance(), this));
-            GetDynamicMaterialInstance()->SetVectorParameterValue(TEXT("FresnelColor"), GetGlowColor());
-            GetItemMesh()->SetMaterial(GetMaterialIndex(), GetDynamicMaterialInstance());
+const FWeaponDataTable* AWeapon::GetWeaponData() const
+{
+    UShooterDataRegistry* DataRegistry = UShooterDataRegistry::Get();
+    return DataRegistry ? DataRegistry->GetWeaponRow(WeaponType) : nullptr;
+}
 
-            EnableGlowMaterial(); //Activating the glow material; happens before the game launches
-        }
+void AWeapon::ApplyPickupAssets()
+{
+    const FWeaponDataTable* WeaponData = GetWeaponData();
+    if (WeaponData == nullptr) return;
+
+    USkeletalMesh* WeaponMesh = WeaponData->ItemMesh.Get();
+    if (WeaponMesh)
+    {
+        GetItemMesh()->SetSkeletalMesh(WeaponMesh);
+    }
+
+    SetMaterialInstance(WeaponData->MaterialInstance.Get());
+    ApplyItemMaterial();
+
+    if (BoneToHide != FName(""))
+    {
+        GetItemMesh()->HideBoneByName(BoneToHide, EPhysBodyOp::PBO_None);
+    }
+}
+
+void AWeapon::ApplyEquipAssets()
+{
+    const FWeaponDataTable* WeaponData = GetWeaponData();
+    if (WeaponData == nullptr) return;
+
+    SetPickupSound(WeaponData->PickupSound.Get());
+    SetEquipSound(WeaponData->EquipSound.Get());
+    SetIconItem(WeaponData->InventoryIcon.Get());
+    SetAmmoIcon(WeaponData->AmmoIcon.Get());
+    CrosshairsMiddle = WeaponData->CrosshairsMiddle.Get();
+    CrosshairsLeft = WeaponData->CrosshairsLeft.Get();
+    CrosshairsRight = WeaponData->CrosshairsRight.Get();
+    CrosshairsTop = WeaponData->CrosshairsTop.Get();
+    CrosshairsBottom = WeaponData->CrosshairsBottom.Get();
+    MuzzleFlash = WeaponData->MuzzleFlash.Get();
+    FireSound = WeaponData->FireSound.Get();
+
+    UClass* AnimClass = WeaponData->AnimBP.Get();
+    if (AnimClass)
+    {
+        GetItemMesh()->SetAnimInstanceClass(AnimClass);
+    }
+}
+
+void AWeapon::ClearEquipAssets()
+{
+    SetPickupSound(nullptr);
+    SetEquipSound(nullptr);
+    SetIconItem(nullptr);
+    SetAmmoIcon(nullptr);
+    CrosshairsMiddle = nullptr;
+    CrosshairsLeft = nullptr;
+    CrosshairsRight = nullptr;
+    CrosshairsTop = nullptr;
+    CrosshairsBottom = nullptr;
+    MuzzleFlash = nullptr;
+    FireSound = nullptr;
+    GetItemMesh()->SetAnimInstanceClass(nullptr);
+}
+
+void AWeapon::SetItemProperties(EItemState State)
+{
+    Super::SetItemProperties(State);
+
+    UpdateEquipAssetRequest();
+}
+
+bool AWeapon::ShouldTick() const
+{
+    return Super::ShouldTick()
+        || (GetItemState() == EItemState::EIS_Falling && bFalling)
+        || bMovingSlide;
+}
+
+void AWeapon::OnPlayerProximityChanged()
+{
+    UpdateEquipAssetRequest();
+}
+
+void AWeapon::UpdateEquipAssetRequest()
+{
+    if (!HasActorBegunPlay() || IsInPool()) return;
+
+    UWeaponAssetStreamer* AssetStreamer = UWeaponAssetStreamer::Get();
+    if (AssetStreamer == nullptr) return;
+
+    // Prefetched while a player could pick it up, held for as long as someone owns it
+    const bool bWantEquipAssets{ GetItemState() != EItemState::EIS_Pickup || GetNearbyPlayerCount() > 0 };
+
+    if (bWantEquipAssets && EquipAssetsType == EWeaponType::EWT_MAX)
+    {
+        EquipAssetsType = WeaponType;
+        AssetStreamer->AcquireAssets(EquipAssetsType, EWeaponAssetTier::EWAT_Equip,
+            FStreamableDelegate::CreateUObject(this, &AWeapon::ApplyEquipAssets));
+    }
+    else if (!bWantEquipAssets && EquipAssetsType != EWeaponType::EWT_MAX)
+    {
+        ClearEquipAssets();
+        AssetStreamer->ReleaseAssets(EquipAssetsType, EWeaponAssetTier::EWAT_Equip);
+        EquipAssetsType = EWeaponType::EWT_MAX;
     }
-  
 
-        
+    if (GetItemState() == EItemState::EIS_Equipped && !AssetStreamer->AreAssetsLoaded(WeaponType, EWeaponAssetTier::EWAT_Equip))
+    {
+        // Equipped before the prefetch finished; it has to fire with its sounds and flash
+        AssetStreamer->WaitForAssets(WeaponType, EWeaponAssetTier::EWAT_Equip);
+    }
 }
 
 void AWeapon::FinishMovingSlide()
 {
     bMovingSlide = false;
+    UpdateTickState();
 }
 
 //Updates the slide displacement and the recoil of the gun
@@ -166,15 +261,85 @@ void AWeapon::BeginPlay()
 {
     Super::BeginPlay();
 
-    if (BoneToHide != FName(""))
+    AcquirePickupAssets();
+    UpdateEquipAssetRequest();
+}
+
+void AWeapon::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    Super::EndPlay(EndPlayReason);
+
+    // After Super: unregistering from the pickup index can still re-request the equip assets
+    ReleaseAssetRequests();
+}
+
+void AWeapon::AcquirePickupAssets()
+{
+    // Parked weapons (including ones instanced straight from BeginPlay) don't hold assets
+    if (IsInPool()) return;
+
+    UWeaponAssetStreamer* AssetStreamer = UWeaponAssetStreamer::Get();
+    if (AssetStreamer && PickupAssetsType == EWeaponType::EWT_MAX)
     {
-        GetItemMesh()->HideBoneByName(BoneToHide, EPhysBodyOp::PBO_None);
+        PickupAssetsType = WeaponType;
+        AssetStreamer->AcquireAssets(PickupAssetsType, EWeaponAssetTier::EWAT_Pickup,
+            FStreamableDelegate::CreateUObject(this, &AWeapon::ApplyPickupAssets));
+    }
+}
+
+void AWeapon::ReleaseAssetRequests()
+{
+    UWeaponAssetStreamer* AssetStreamer = UWeaponAssetStreamer::Get();
+    if (AssetStreamer)
+    {
+        if (PickupAssetsType != EWeaponType::EWT_MAX)
+        {
+            AssetStreamer->ReleaseAssets(PickupAssetsType, EWeaponAssetTier::EWAT_Pickup);
+            PickupAssetsType = EWeaponType::EWT_MAX;
+        }
+        if (EquipAssetsType != EWeaponType::EWT_MAX)
+        {
+            AssetStreamer->ReleaseAssets(EquipAssetsType, EWeaponAssetTier::EWAT_Equip);
+            EquipAssetsType = EWeaponType::EWT_MAX;
+        }
+    }
+}
+
+void AWeapon::OnReleasedToPool()
+{
+    bFalling = false;
+    bMovingSlide = false;
+
+    Super::OnReleasedToPool();
+
+    ClearEquipAssets();
+    ReleaseAssetRequests();
+}
+
+void AWeapon::OnAcquiredFromPool(const FTransform& SpawnTransform)
+{
+    // Pooled weapons start from their class, whatever type they were last used as
+    const EWeaponType DefaultWeaponType{ GetClass()->GetDefaultObject<AWeapon>()->WeaponType };
+    if (WeaponType != DefaultWeaponType)
+    {
+        WeaponType = DefaultWeaponType;
+        ApplyWeaponData();
     }
+
+    const FWeaponDataTable* WeaponData = GetWeaponData();
+    Ammo = WeaponData ? WeaponData->WeaponAmmo : GetClass()->GetDefaultObject<AWeapon>()->Ammo;
+    SlideDisplacement = 0.f;
+    RecoilRotation = 0.f;
+
+    Super::OnAcquiredFromPool(SpawnTransform);
+
+    AcquirePickupAssets();
 }
 
 void AWeapon::StartSlideTimer()
 {
     bMovingSlide = true;
+    UpdateTickState();
     GetWorldTimerManager().SetTimer(SlideTimer, this, &AWeapon::FinishMovingSlide, SlideDisplacementTime);
 }
 
@@ -195,7 +360,62 @@ void AWeapon::ReloadAmmo(int32 Amount)
     Ammo += Amount;
 }
 
+float FBulletDamage::GetZoneDamage(EHitZone Zone) const
+{
+    switch (Zone)
+    {
+    case EHitZone::EHZ_Head:
+        return HeadShotDamage;
+
+    case EHitZone::EHZ_Limb:
+        return LimbDamage > 0.f ? LimbDamage : Damage;
+    }
+    return Damage;
+}
+
+float AWeapon::GetZoneDamage(EHitZone Zone) const
+{
+    return GetBulletDamage().GetZoneDamage(Zone);
+}
+
+FBulletDamage AWeapon::GetBulletDamage() const
+{
+    FBulletDamage BulletDamage;
+    BulletDamage.Damage = Damage;
+    BulletDamage.HeadShotDamage = HeadShotDamage;
+    BulletDamage.LimbDamage = LimbDamage;
+    return BulletDamage;
+}
+
 bool AWeapon::ClipIsFull()
 {
     return Ammo >= MagazineCapacity;
 }
+
+FWeaponRecord AWeapon::MakeRecord() const
+{
+    FWeaponRecord Record;
+    Record.WeaponClass = GetClass();
+    Record.WeaponType = WeaponType;
+    Record.ItemRarity = GetItemRarity();
+    Record.Ammo = Ammo;
+    Record.SlotIndex = GetSlotIndex();
+    return Record;
+}
+
+void AWeapon::ApplyRecord(const FWeaponRecord& Record)
+{
+    if (Record.WeaponType != WeaponType)
+    {
+        // The pool handed back a weapon set up for its class default type
+        ReleaseAssetRequests();
+        WeaponType = Record.WeaponType;
+        ApplyWeaponData();
+        AcquirePickupAssets();
+        UpdateEquipAssetRequest();
+    }
+
+    SetItemRarity(Record.ItemRarity);
+    Ammo = Record.Ammo;
+    SetSlotIndex(Record.SlotIndex);
+}
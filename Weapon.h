@@ -7,8 +7,14 @@
 #include "AmmoType.h"
 #include "Engine/DataTable.h"
 #include "WeaponType.h"
+#include "HitZone.h"
+#include "FireMode.h"
 #include "Weapon.generated.h"
 
+class USoundCue;
+class UParticleSystem;
+
+/* Asset references are soft; UWeaponAssetStreamer streams them per weapon type*/
 USTRUCT(BlueprintType)
 struct FWeaponDataTable : public FTableRowBase
 {
@@ -24,25 +30,25 @@ struct FWeaponDataTable : public FTableRowBase
 	int32 MagazineCapacity;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	class USoundCue* PickupSound;
+	TSoftObjectPtr<USoundCue> PickupSound;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	USoundCue* EquipSound;
+	TSoftObjectPtr<USoundCue> EquipSound;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	USkeletalMesh* ItemMesh;
+	TSoftObjectPtr<USkeletalMesh> ItemMesh;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	FString ItemName;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* InventoryIcon;
+	TSoftObjectPtr<UTexture2D> InventoryIcon;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* AmmoIcon;
+	TSoftObjectPtr<UTexture2D> AmmoIcon;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UMaterialInstance* MaterialInstance;
+	TSoftObjectPtr<UMaterialInstance> MaterialInstance;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	int32 MaterialIndex;
@@ -54,31 +60,31 @@ struct FWeaponDataTable : public FTableRowBase
 	FName ReloadMontageSection;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	TSubclassOf<UAnimInstance> AnimBP;
+	TSoftClassPtr<UAnimInstance> AnimBP;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* CrosshairsMiddle;
+	TSoftObjectPtr<UTexture2D> CrosshairsMiddle;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* CrosshairsLeft;
+	TSoftObjectPtr<UTexture2D> CrosshairsLeft;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* CrosshairsRight;
+	TSoftObjectPtr<UTexture2D> CrosshairsRight;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* CrosshairsTop;
+	TSoftObjectPtr<UTexture2D> CrosshairsTop;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* CrosshairsBottom;
+	TSoftObjectPtr<UTexture2D> CrosshairsBottom;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float AutoFireRate;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UParticleSystem* MuzzleFlash;
+	TSoftObjectPtr<UParticleSystem> MuzzleFlash;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	USoundCue* FireSound;
+	TSoftObjectPtr<USoundCue> FireSound;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	FName BoneToHide;
@@ -91,6 +97,59 @@ struct FWeaponDataTable : public FTableRowBase
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float HeadShotDamage;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float LimbDamage;
+
+	/* Hitscan resolves shots with traces; ballistic rounds fly with travel time and drop*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EFireMode FireMode = EFireMode::EFM_Hitscan;
+
+	/* Speed of a ballistic round leaving the barrel, in cm/s*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float MuzzleVelocity = 60000.f;
+
+	/* Multiplier on world gravity for ballistic rounds*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float GravityScale = 1.f;
+};
+
+/* A weapon's damage when a shot was fired, so the hit doesn't depend on the weapon actor still being the same weapon*/
+struct FBulletDamage
+{
+	float Damage = 0.f;
+
+	float HeadShotDamage = 0.f;
+
+	/* Uses Damage when zero*/
+	float LimbDamage = 0.f;
+
+	float GetZoneDamage(EHitZone Zone) const;
+};
+
+/* A weapon sitting in an inventory slot, kept as data instead of a hidden actor*/
+USTRUCT(BlueprintType)
+struct FWeaponRecord
+{
+	GENERATED_BODY()
+
+	/* Class the actor is rehydrated from; null for an empty slot*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	TSubclassOf<class AWeapon> WeaponClass;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	EWeaponType WeaponType = EWeaponType::EWT_MAX;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	EItemRarity ItemRarity = EItemRarity::EIR_Common;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Ammo = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 SlotIndex = 0;
+
+	FORCEINLINE bool IsEmpty() const { return WeaponClass == nullptr; }
 };
 
 /**
@@ -114,6 +173,46 @@ protected:
 
 	void FinishMovingSlide();
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void SetItemProperties(EItemState State) override;
+
+	virtual void OnPlayerProximityChanged() override;
+
+	/* Also ticks while thrown and while the slide is moving*/
+	virtual bool ShouldTick() const override;
+
+public:
+
+	/* Also lets go of the streamed assets while parked*/
+	virtual void OnReleasedToPool() override;
+
+	/* Refills the magazine and requests the pickup assets again*/
+	virtual void OnAcquiredFromPool(const FTransform& SpawnTransform) override;
+
+protected:
+
+	/* Holds the equip assets while a player is near or the weapon is owned, and lets go otherwise*/
+	void UpdateEquipAssetRequest();
+
+	/* Copy the streamed mesh and material from the weapon's row*/
+	void ApplyPickupAssets();
+
+	/* Copy the streamed sounds, icons, crosshairs, muzzle flash and anim blueprint from the weapon's row*/
+	void ApplyEquipAssets();
+
+	/* Drop references to the equip assets so they can unload*/
+	void ClearEquipAssets();
+
+	/* Requests the pickup tier for WeaponType*/
+	void AcquirePickupAssets();
+
+	/* Lets go of every asset tier this weapon holds*/
+	void ReleaseAssetRequests();
+
+	/* Copies the WeaponType row from the data registry into this weapon*/
+	void ApplyWeaponData();
+
 private:
 
 	virtual void BeginPlay() override;
@@ -233,6 +332,28 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
 		float HeadShotDamage;
 
+	/* Amount of damage when bullet hits an arm or leg. Uses Damage when zero*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	float LimbDamage;
+
+	/* Whether shots are traced or flown as ballistic rounds*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	EFireMode FireMode;
+
+	/* Speed of a ballistic round leaving the barrel*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	float MuzzleVelocity;
+
+	/* Multiplier on world gravity for ballistic rounds*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	float GravityScale;
+
+	/* Weapon type whose pickup assets this weapon holds, EWT_MAX when none*/
+	EWeaponType PickupAssetsType;
+
+	/* Weapon type whose equip assets this weapon holds, EWT_MAX when none*/
+	EWeaponType EquipAssetsType;
+
 public:
 
 	// Adds impulse to the weapon	
@@ -269,6 +390,27 @@ public:
 
 	FORCEINLINE float GetHeadShotDamage() const { return HeadShotDamage; }
 
+	FORCEINLINE EFireMode GetFireMode() const { return FireMode; }
+
+	FORCEINLINE float GetMuzzleVelocity() const { return MuzzleVelocity; }
+
+	FORCEINLINE float GetGravityScale() const { return GravityScale; }
+
+	/* This weapon's row, looked up by WeaponType each time so a reimported table is never read through a stale row*/
+	const FWeaponDataTable* GetWeaponData() const;
+
+	/* Everything needed to rebuild this weapon in an inventory slot*/
+	FWeaponRecord MakeRecord() const;
+
+	/* Takes the type, rarity, ammo and slot from Record. Used on a weapon fresh from the pickup pool*/
+	void ApplyRecord(const FWeaponRecord& Record);
+
+	/* Base damage for a hit in Zone*/
+	float GetZoneDamage(EHitZone Zone) const;
+
+	/* Current damage values, captured when a shot is fired*/
+	FBulletDamage GetBulletDamage() const;
+
 	void StartSlideTimer();
 
 	/** Called from character class when firing weapon*/
@@ -0,0 +1,223 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WeaponAssetStreamer.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "Weapon.h"
+#include "ShooterDataRegistry.h"
+#include "Shooter.h"
+
+static FAutoConsoleCommand CVarDumpWeaponAssets(
+	TEXT("Shooter.DumpWeaponAssets"),
+	TEXT("Logs streamed weapon asset references and resident memory per weapon type."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		if (UWeaponAssetStreamer* Streamer = UWeaponAssetStreamer::Get())
+		{
+			Streamer->DumpResidentAssets();
+		}
+	}));
+
+void UWeaponAssetStreamer::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Requests.SetNum(static_cast<int32>(EWeaponType::EWT_MAX) * static_cast<int32>(EWeaponAssetTier::EWAT_MAX));
+}
+
+void UWeaponAssetStreamer::Deinitialize()
+{
+	for (FWeaponAssetRequest& Request : Requests)
+	{
+		if (Request.Handle.IsValid())
+		{
+			Request.Handle->ReleaseHandle();
+		}
+	}
+	Requests.Empty();
+
+	Super::Deinitialize();
+}
+
+UWeaponAssetStreamer* UWeaponAssetStreamer::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UWeaponAssetStreamer>() : nullptr;
+}
+
+FWeaponAssetRequest& UWeaponAssetStreamer::GetRequest(EWeaponType WeaponType, EWeaponAssetTier Tier)
+{
+	return Requests[static_cast<int32>(WeaponType) * static_cast<int32>(EWeaponAssetTier::EWAT_MAX) + static_cast<int32>(Tier)];
+}
+
+const FWeaponAssetRequest& UWeaponAssetStreamer::GetRequest(EWeaponType WeaponType, EWeaponAssetTier Tier) const
+{
+	return Requests[static_cast<int32>(WeaponType) * static_cast<int32>(EWeaponAssetTier::EWAT_MAX) + static_cast<int32>(Tier)];
+}
+
+void UWeaponAssetStreamer::AcquireAssets(EWeaponType WeaponType, EWeaponAssetTier Tier, FStreamableDelegate OnLoaded)
+{
+	if (WeaponType == EWeaponType::EWT_MAX) return;
+
+	FWeaponAssetRequest& Request = GetRequest(WeaponType, Tier);
+	++Request.RefCount;
+
+	if (!Request.Handle.IsValid())
+	{
+		UShooterDataRegistry* DataRegistry = UShooterDataRegistry::Get();
+		const FWeaponDataTable* WeaponRow = DataRegistry ? DataRegistry->GetWeaponRow(WeaponType) : nullptr;
+		if (WeaponRow == nullptr) return;
+
+		TArray<FSoftObjectPath> AssetPaths;
+		GetTierAssetPaths(*WeaponRow, Tier, AssetPaths);
+		if (AssetPaths.Num() == 0)
+		{
+			OnLoaded.ExecuteIfBound();
+			return;
+		}
+
+		Request.Handle = StreamableManager.RequestAsyncLoad(AssetPaths,
+			FStreamableDelegate::CreateUObject(this, &UWeaponAssetStreamer::OnAssetsLoaded, WeaponType, Tier));
+	}
+
+	if (Request.Handle.IsValid() && Request.Handle->HasLoadCompleted())
+	{
+		OnLoaded.ExecuteIfBound();
+	}
+	else if (OnLoaded.IsBound())
+	{
+		Request.PendingCallbacks.Add(OnLoaded);
+	}
+}
+
+void UWeaponAssetStreamer::ReleaseAssets(EWeaponType WeaponType, EWeaponAssetTier Tier)
+{
+	if (WeaponType == EWeaponType::EWT_MAX) return;
+
+	FWeaponAssetRequest& Request = GetRequest(WeaponType, Tier);
+	if (Request.RefCount <= 0) return;
+
+	if (--Request.RefCount == 0)
+	{
+		if (Request.Handle.IsValid())
+		{
+			Request.Handle->ReleaseHandle();
+			Request.Handle.Reset();
+		}
+		Request.PendingCallbacks.Empty();
+	}
+}
+
+bool UWeaponAssetStreamer::AreAssetsLoaded(EWeaponType WeaponType, EWeaponAssetTier Tier) const
+{
+	if (WeaponType == EWeaponType::EWT_MAX) return false;
+
+	const FWeaponAssetRequest& Request = GetRequest(WeaponType, Tier);
+	return Request.Handle.IsValid() && Request.Handle->HasLoadCompleted();
+}
+
+void UWeaponAssetStreamer::WaitForAssets(EWeaponType WeaponType, EWeaponAssetTier Tier)
+{
+	if (WeaponType == EWeaponType::EWT_MAX) return;
+
+	FWeaponAssetRequest& Request = GetRequest(WeaponType, Tier);
+	if (Request.Handle.IsValid() && Request.Handle->IsLoadingInProgress())
+	{
+		UE_LOG(LogShooter, Verbose, TEXT("Waiting on %s assets that weren't prefetched"), *UEnum::GetValueAsString(WeaponType));
+		Request.Handle->WaitUntilComplete();
+	}
+}
+
+void UWeaponAssetStreamer::OnAssetsLoaded(EWeaponType WeaponType, EWeaponAssetTier Tier)
+{
+	// Callbacks can acquire or release, so run them from a copy
+	TArray<FStreamableDelegate> Callbacks = MoveTemp(GetRequest(WeaponType, Tier).PendingCallbacks);
+	for (FStreamableDelegate& Callback : Callbacks)
+	{
+		Callback.ExecuteIfBound();
+	}
+}
+
+void UWeaponAssetStreamer::GetTierAssetPaths(const FWeaponDataTable& WeaponRow, EWeaponAssetTier Tier, TArray<FSoftObjectPath>& OutPaths)
+{
+	auto AddPath = [&OutPaths](const FSoftObjectPath& Path)
+	{
+		if (Path.IsValid())
+		{
+			OutPaths.AddUnique(Path);
+		}
+	};
+
+	if (Tier == EWeaponAssetTier::EWAT_Pickup)
+	{
+		AddPath(WeaponRow.ItemMesh.ToSoftObjectPath());
+		AddPath(WeaponRow.MaterialInstance.ToSoftObjectPath());
+		return;
+	}
+
+	AddPath(WeaponRow.PickupSound.ToSoftObjectPath());
+	AddPath(WeaponRow.EquipSound.ToSoftObjectPath());
+	AddPath(WeaponRow.FireSound.ToSoftObjectPath());
+	AddPath(WeaponRow.InventoryIcon.ToSoftObjectPath());
+	AddPath(WeaponRow.AmmoIcon.ToSoftObjectPath());
+	AddPath(WeaponRow.AnimBP.ToSoftObjectPath());
+	AddPath(WeaponRow.CrosshairsMiddle.ToSoftObjectPath());
+	AddPath(WeaponRow.CrosshairsLeft.ToSoftObjectPath());
+	AddPath(WeaponRow.CrosshairsRight.ToSoftObjectPath());
+	AddPath(WeaponRow.CrosshairsTop.ToSoftObjectPath());
+	AddPath(WeaponRow.CrosshairsBottom.ToSoftObjectPath());
+	AddPath(WeaponRow.MuzzleFlash.ToSoftObjectPath());
+}
+
+void UWeaponAssetStreamer::LoadRowSynchronous(const FWeaponDataTable& WeaponRow)
+{
+	TArray<FSoftObjectPath> AssetPaths;
+	GetTierAssetPaths(WeaponRow, EWeaponAssetTier::EWAT_Pickup, AssetPaths);
+	GetTierAssetPaths(WeaponRow, EWeaponAssetTier::EWAT_Equip, AssetPaths);
+
+	for (const FSoftObjectPath& AssetPath : AssetPaths)
+	{
+		AssetPath.TryLoad();
+	}
+}
+
+int64 UWeaponAssetStreamer::GetResidentBytes(EWeaponType WeaponType) const
+{
+	if (WeaponType == EWeaponType::EWT_MAX) return 0;
+
+	int64 ResidentBytes{ 0 };
+	for (int32 Tier = 0; Tier < static_cast<int32>(EWeaponAssetTier::EWAT_MAX); Tier++)
+	{
+		const FWeaponAssetRequest& Request = GetRequest(WeaponType, static_cast<EWeaponAssetTier>(Tier));
+		if (!Request.Handle.IsValid()) continue;
+
+		TArray<UObject*> LoadedAssets;
+		Request.Handle->GetLoadedAssets(LoadedAssets);
+		for (UObject* Asset : LoadedAssets)
+		{
+			if (Asset)
+			{
+				ResidentBytes += Asset->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+			}
+		}
+	}
+	return ResidentBytes;
+}
+
+void UWeaponAssetStreamer::DumpResidentAssets() const
+{
+	for (int32 i = 0; i < static_cast<int32>(EWeaponType::EWT_MAX); i++)
+	{
+		const EWeaponType WeaponType{ static_cast<EWeaponType>(i) };
+		const FWeaponAssetRequest& PickupRequest = GetRequest(WeaponType, EWeaponAssetTier::EWAT_Pickup);
+		const FWeaponAssetRequest& EquipRequest = GetRequest(WeaponType, EWeaponAssetTier::EWAT_Equip);
+
+		UE_LOG(LogShooter, Display, TEXT("%s: pickup refs %d (%s), equip refs %d (%s), %.1f KB resident"),
+			*UEnum::GetValueAsString(WeaponType),
+			PickupRequest.RefCount,
+			AreAssetsLoaded(WeaponType, EWeaponAssetTier::EWAT_Pickup) ? TEXT("loaded") : TEXT("not loaded"),
+			EquipRequest.RefCount,
+			AreAssetsLoaded(WeaponType, EWeaponAssetTier::EWAT_Equip) ? TEXT("loaded") : TEXT("not loaded"),
+			GetResidentBytes(WeaponType) / 1024.f);
+	}
+}
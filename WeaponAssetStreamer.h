@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Engine/StreamableManager.h"
+#include "WeaponType.h"
+#include "WeaponAssetStreamer.generated.h"
+
+struct FWeaponDataTable;
+
+/* Which of a weapon type's assets a request is for*/
+enum class EWeaponAssetTier : uint8
+{
+	/* Mesh and material; needed while a pickup of the type exists*/
+	EWAT_Pickup,
+
+	/* Sounds, icons, crosshairs, muzzle flash and anim blueprint; needed near a player or once picked up*/
+	EWAT_Equip,
+
+	EWAT_MAX
+};
+
+/* Streamed assets of one tier for one weapon type*/
+struct FWeaponAssetRequest
+{
+	TSharedPtr<FStreamableHandle> Handle;
+
+	/* Weapons holding this tier; the handle is released at zero*/
+	int32 RefCount = 0;
+
+	/* Called when the handle finishes loading*/
+	TArray<FStreamableDelegate> PendingCallbacks;
+};
+
+/**
+ * Streams the soft-referenced assets in the weapon data table.
+ * Each weapon type's assets load asynchronously in two tiers, are reference
+ * counted by the weapons using them and are released when the count drops to zero.
+ */
+UCLASS()
+class SHOOTER_API UWeaponAssetStreamer : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	static UWeaponAssetStreamer* Get();
+
+	/* Adds a reference to a tier and starts streaming it if needed. OnLoaded runs once it is resident (now if it already is)*/
+	void AcquireAssets(EWeaponType WeaponType, EWeaponAssetTier Tier, FStreamableDelegate OnLoaded);
+
+	/* Drops a reference; the tier is unloaded on the next GC once no weapon holds it*/
+	void ReleaseAssets(EWeaponType WeaponType, EWeaponAssetTier Tier);
+
+	/* True when every asset of the tier is resident*/
+	bool AreAssetsLoaded(EWeaponType WeaponType, EWeaponAssetTier Tier) const;
+
+	/* Blocks until the tier has finished streaming. For when a prefetch didn't finish in time*/
+	void WaitForAssets(EWeaponType WeaponType, EWeaponAssetTier Tier);
+
+	/* Loads every asset in a row right away. Used by editor construction scripts*/
+	static void LoadRowSynchronous(const FWeaponDataTable& WeaponRow);
+
+	/* Bytes used by the streamed assets of WeaponType*/
+	UFUNCTION(BlueprintCallable, Category = "Weapon Assets")
+	int64 GetResidentBytes(EWeaponType WeaponType) const;
+
+	/* Logs references and resident memory for every weapon type*/
+	void DumpResidentAssets() const;
+
+private:
+
+	FWeaponAssetRequest& GetRequest(EWeaponType WeaponType, EWeaponAssetTier Tier);
+	const FWeaponAssetRequest& GetRequest(EWeaponType WeaponType, EWeaponAssetTier Tier) const;
+
+	static void GetTierAssetPaths(const FWeaponDataTable& WeaponRow, EWeaponAssetTier Tier, TArray<FSoftObjectPath>& OutPaths);
+
+	void OnAssetsLoaded(EWeaponType WeaponType, EWeaponAssetTier Tier);
+
+	FStreamableManager StreamableManager;
+
+	/* Indexed by EWeaponType * EWAT_MAX + tier*/
+	TArray<FWeaponAssetRequest> Requests;
+};